@@ -6,11 +6,11 @@ Implements standard CER and WER calculations used in OCR research
 
 import json
 import argparse
+import multiprocessing
 import os
 import sys
-from typing import Dict, List, Tuple, Optional
+from typing import Dict, List, Tuple, Optional, Sequence, Hashable
 import unicodedata
-import jiwer
 
 def normalize_text_research_standard(text: str) -> str:
     """
@@ -47,10 +47,94 @@ def normalize_text_research_standard(text: str) -> str:
     
     return text.translate(translator)
 
+def _strip_common_affix(ref: Sequence[Hashable], hyp: Sequence[Hashable]) -> Tuple[Sequence[Hashable], Sequence[Hashable]]:
+    """Drop the shared prefix and suffix, which never contribute edits."""
+    limit = min(len(ref), len(hyp))
+    prefix = 0
+    while prefix < limit and ref[prefix] == hyp[prefix]:
+        prefix += 1
+    suffix = 0
+    while suffix < limit - prefix and ref[len(ref) - 1 - suffix] == hyp[len(hyp) - 1 - suffix]:
+        suffix += 1
+    return ref[prefix:len(ref) - suffix], hyp[prefix:len(hyp) - suffix]
+
+def levenshtein_edit_counts(reference: Sequence[Hashable], hypothesis: Sequence[Hashable]) -> Dict[str, int]:
+    """
+    Bit-parallel Levenshtein distance (Myers 1999 / Hyyro 2003) with S/I/D recovery.
+
+    Every position of the reference is one bit of the vertical delta vectors VP/VN,
+    so one row of the DP matrix costs a handful of word operations instead of
+    len(reference) cell updates. Python integers are arbitrary precision, which
+    gives the multi-word block representation for long pages for free: CPython
+    propagates the carry of the "+" in the D0 step across its internal digits.
+
+    The VP/VN vectors of each row are kept so the alignment can be walked back
+    (Hyyro 2004). The walk prefers deletion, then insertion, then diagonal, the
+    same order rapidfuzz uses for the editops jiwer counts, so the S/I/D split
+    matches the previous jiwer based numbers.
+
+    Works on any sequence of hashables: code points for CER, word lists for WER.
+    """
+    ref, hyp = _strip_common_affix(reference, hypothesis)
+    if not ref or not hyp:
+        return {'distance': len(ref) + len(hyp), 'substitutions': 0,
+                'insertions': len(hyp), 'deletions': len(ref)}
+
+    # Match masks: bit i of peq[c] is set when ref[i] == c
+    peq: Dict[Hashable, int] = {}
+    bit = 1
+    for token in ref:
+        peq[token] = peq.get(token, 0) | bit
+        bit <<= 1
+
+    full = (1 << len(ref)) - 1
+    last = 1 << (len(ref) - 1)
+    vp = full
+    vn = 0
+    dist = len(ref)
+    rows_vp: List[int] = []
+    rows_vn: List[int] = []
+    for token in hyp:
+        eq = peq.get(token, 0)
+        d0 = ((((eq & vp) + vp) & full) ^ vp) | eq | vn
+        hp = vn | (~(d0 | vp) & full)
+        hn = d0 & vp
+        if hp & last:
+            dist += 1
+        elif hn & last:
+            dist -= 1
+        hp = ((hp << 1) | 1) & full
+        hn = (hn << 1) & full
+        vp = hn | (~(d0 | hp) & full)
+        vn = hp & d0
+        rows_vp.append(vp)
+        rows_vn.append(vn)
+
+    substitutions = insertions = deletions = 0
+    col = len(ref)
+    row = len(hyp)
+    while row and col:
+        if (rows_vp[row - 1] >> (col - 1)) & 1:
+            deletions += 1
+            col -= 1
+            continue
+        row -= 1
+        if row and (rows_vn[row - 1] >> (col - 1)) & 1:
+            insertions += 1
+            continue
+        col -= 1
+        if ref[col] != hyp[row]:
+            substitutions += 1
+    deletions += col
+    insertions += row
+
+    return {'distance': dist, 'substitutions': substitutions,
+            'insertions': insertions, 'deletions': deletions}
+
 def calculate_character_error_rate(reference: str, hypothesis: str) -> Dict[str, float]:
     """
-    Calculate Character Error Rate (CER) and other metrics using the jiwer library.
-    jiwer is a standard, well-tested library for this purpose.
+    Calculate Character Error Rate (CER) and S/I/D counts over code points
+    with the bit-parallel edit distance above.
     """
     ref_norm = normalize_text_research_standard(reference)
     hyp_norm = normalize_text_research_standard(hypothesis)
@@ -66,49 +150,351 @@ def calculate_character_error_rate(reference: str, hypothesis: str) -> Dict[str,
             'hyp_length': len(hyp_norm)
         }
 
-    # Use jiwer to compute all metrics at once
-    # For character-level, we pass the strings directly.
-    # For word-level, we would pass lists of words.
-    error = jiwer.cer(ref_norm, hyp_norm)
-    
-    # Manually calculate accuracy from the error rate
+    # Python str indexing is already per code point, so no decoding step is needed
+    counts = levenshtein_edit_counts(ref_norm, hyp_norm)
+    error = counts['distance'] / len(ref_norm)
     accuracy = max(0.0, 1.0 - error)
-    
-    # To get detailed S/I/D counts, we can use process_words/process_characters
-    # but for simplicity and to match the core metric, cer is sufficient.
-    # Let's get the detailed output for the full report.
-    output = jiwer.process_characters(ref_norm, hyp_norm)
 
     return {
         'cer': error,
         'accuracy': accuracy,
-        'substitutions': output.substitutions,
-        'insertions': output.insertions,
-        'deletions': output.deletions,
+        'substitutions': counts['substitutions'],
+        'insertions': counts['insertions'],
+        'deletions': counts['deletions'],
         'ref_length': len(ref_norm),
         'hyp_length': len(hyp_norm)
     }
 
 def calculate_word_error_rate(reference: str, hypothesis: str) -> Dict[str, float]:
     """
-    Calculate Word Error Rate (WER) using the jiwer library.
+    Calculate Word Error Rate (WER) over whitespace separated words.
     """
-    ref_norm = normalize_text_research_standard(reference)
-    hyp_norm = normalize_text_research_standard(hypothesis)
-    
-    # Use jiwer's default transformation, which handles splitting into words.
-    error = jiwer.wer(ref_norm, hyp_norm)
+    ref_words = normalize_text_research_standard(reference).split()
+    hyp_words = normalize_text_research_standard(hypothesis).split()
+
+    if len(ref_words) == 0:
+        error = 0.0 if len(hyp_words) == 0 else 1.0
+    else:
+        error = levenshtein_edit_counts(ref_words, hyp_words)['distance'] / len(ref_words)
     accuracy = max(0.0, 1.0 - error)
-    output = jiwer.process_words(ref_norm, hyp_norm)
-    
+
     return {
         'wer': error,
         'accuracy': accuracy,
-        'ref_word_count': output.references,
-        'hyp_word_count': output.hypotheses
+        'ref_word_count': len(ref_words),
+        'hyp_word_count': len(hyp_words)
+    }
+
+Point = Tuple[float, float]
+
+def _convex_hull(points: Sequence[Sequence[float]]) -> List[Point]:
+    """Counter-clockwise convex hull (monotone chain). Quads are tiny, so this is cheap."""
+    pts = sorted(set((float(p[0]), float(p[1])) for p in points))
+    if len(pts) <= 2:
+        return pts
+
+    def cross(o: Point, a: Point, b: Point) -> float:
+        return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+
+    lower: List[Point] = []
+    for p in pts:
+        while len(lower) >= 2 and cross(lower[-2], lower[-1], p) <= 0:
+            lower.pop()
+        lower.append(p)
+    upper: List[Point] = []
+    for p in reversed(pts):
+        while len(upper) >= 2 and cross(upper[-2], upper[-1], p) <= 0:
+            upper.pop()
+        upper.append(p)
+    return lower[:-1] + upper[:-1]
+
+def _polygon_area(poly: Sequence[Point]) -> float:
+    area = 0.0
+    for i in range(len(poly)):
+        x1, y1 = poly[i]
+        x2, y2 = poly[(i + 1) % len(poly)]
+        area += x1 * y2 - x2 * y1
+    return abs(area) / 2.0
+
+def _clip_convex(subject: List[Point], clip: List[Point]) -> List[Point]:
+    """Sutherland-Hodgman clipping of a convex polygon by a counter-clockwise convex polygon."""
+    output = subject
+    for i in range(len(clip)):
+        if not output:
+            break
+        ax, ay = clip[i]
+        bx, by = clip[(i + 1) % len(clip)]
+        ex, ey = bx - ax, by - ay
+        source = output
+        output = []
+        for j in range(len(source)):
+            px, py = source[j]
+            qx, qy = source[(j + 1) % len(source)]
+            p_side = ex * (py - ay) - ey * (px - ax)
+            q_side = ex * (qy - ay) - ey * (qx - ax)
+            if p_side >= 0:
+                output.append((px, py))
+            if (p_side >= 0) != (q_side >= 0):
+                t = p_side / (p_side - q_side)
+                output.append((px + t * (qx - px), py + t * (qy - py)))
+    return output
+
+class _Region:
+    """A text polygon prepared for IoU queries: convex hull, area and axis-aligned bounds."""
+    __slots__ = ('hull', 'area', 'x0', 'y0', 'x1', 'y1')
+
+    def __init__(self, points: Sequence[Sequence[float]]):
+        self.hull = _convex_hull(points)
+        self.area = _polygon_area(self.hull) if len(self.hull) >= 3 else 0.0
+        xs = [p[0] for p in self.hull] or [0.0]
+        ys = [p[1] for p in self.hull] or [0.0]
+        self.x0, self.y0, self.x1, self.y1 = min(xs), min(ys), max(xs), max(ys)
+
+def polygon_iou(a: _Region, b: _Region) -> float:
+    if a.area <= 0 or b.area <= 0:
+        return 0.0
+    if a.x1 <= b.x0 or b.x1 <= a.x0 or a.y1 <= b.y0 or b.y1 <= a.y0:
+        return 0.0
+    inter = _polygon_area(_clip_convex(a.hull, b.hull))
+    union = a.area + b.area - inter
+    return inter / union if union > 0 else 0.0
+
+class _GridIndex:
+    """
+    Uniform grid over region bounding boxes. A query only touches the cells its
+    own bounds cover, so pairing N predictions with M labels costs about
+    O(N + M) on a page instead of O(N * M).
+    """
+
+    def __init__(self, regions: Sequence[_Region]):
+        self.cells: Dict[Tuple[int, int], List[int]] = {}
+        if not regions:
+            self.cell = 1.0
+            return
+        x0 = min(r.x0 for r in regions)
+        y0 = min(r.y0 for r in regions)
+        x1 = max(r.x1 for r in regions)
+        y1 = max(r.y1 for r in regions)
+        # Roughly one region per cell on an evenly filled page
+        self.cell = max(16.0, ((x1 - x0) * (y1 - y0) / len(regions)) ** 0.5)
+        for idx, r in enumerate(regions):
+            for key in self._cover(r):
+                self.cells.setdefault(key, []).append(idx)
+
+    def _cover(self, r: _Region):
+        for gx in range(int(r.x0 // self.cell), int(r.x1 // self.cell) + 1):
+            for gy in range(int(r.y0 // self.cell), int(r.y1 // self.cell) + 1):
+                yield (gx, gy)
+
+    def query(self, r: _Region) -> List[int]:
+        found = set()
+        for key in self._cover(r):
+            bucket = self.cells.get(key)
+            if bucket:
+                found.update(bucket)
+        return sorted(found)
+
+def _candidate_pairs(preds: Sequence[_Region], gts: Sequence[_Region]) -> List[Tuple[float, int, int]]:
+    """All (iou, pred_idx, gt_idx) with a non-zero overlap."""
+    index = _GridIndex(gts)
+    pairs = []
+    for p_idx, pred in enumerate(preds):
+        for g_idx in index.query(pred):
+            iou = polygon_iou(pred, gts[g_idx])
+            if iou > 0:
+                pairs.append((iou, p_idx, g_idx))
+    return pairs
+
+def _match_greedy(pairs: Sequence[Tuple[float, int, int]], iou_threshold: float) -> List[Tuple[int, int, float]]:
+    matched = []
+    used_pred = set()
+    used_gt = set()
+    for iou, p_idx, g_idx in sorted(pairs, key=lambda x: (-x[0], x[1], x[2])):
+        if iou < iou_threshold:
+            break
+        if p_idx in used_pred or g_idx in used_gt:
+            continue
+        used_pred.add(p_idx)
+        used_gt.add(g_idx)
+        matched.append((p_idx, g_idx, iou))
+    return matched
+
+def _hungarian_min(cost: List[List[float]]) -> List[int]:
+    """Rectangular assignment (rows <= cols), returns the assigned column per row."""
+    n, m = len(cost), len(cost[0])
+    inf = float('inf')
+    u = [0.0] * (n + 1)
+    v = [0.0] * (m + 1)
+    p = [0] * (m + 1)
+    way = [0] * (m + 1)
+    for i in range(1, n + 1):
+        p[0] = i
+        j0 = 0
+        minv = [inf] * (m + 1)
+        used = [False] * (m + 1)
+        while True:
+            used[j0] = True
+            i0 = p[j0]
+            delta = inf
+            j1 = 0
+            for j in range(1, m + 1):
+                if not used[j]:
+                    cur = cost[i0 - 1][j - 1] - u[i0] - v[j]
+                    if cur < minv[j]:
+                        minv[j] = cur
+                        way[j] = j0
+                    if minv[j] < delta:
+                        delta = minv[j]
+                        j1 = j
+            for j in range(m + 1):
+                if used[j]:
+                    u[p[j]] += delta
+                    v[j] -= delta
+                else:
+                    minv[j] -= delta
+            j0 = j1
+            if p[j0] == 0:
+                break
+        while j0:
+            j1 = way[j0]
+            p[j0] = p[j1]
+            j0 = j1
+    assignment = [-1] * n
+    for j in range(1, m + 1):
+        if p[j]:
+            assignment[p[j] - 1] = j - 1
+    return assignment
+
+def _match_hungarian(pairs: Sequence[Tuple[float, int, int]], iou_threshold: float) -> List[Tuple[int, int, float]]:
+    """
+    Optimal one-to-one matching that maximizes the number of matches, then total IoU.
+    Solved per connected component of the overlap graph so a dense page stays a
+    set of small assignment problems.
+    """
+    edges = [(p_idx, g_idx, iou) for iou, p_idx, g_idx in pairs if iou >= iou_threshold]
+    if not edges:
+        return []
+
+    # Union-find over ('p', i) / ('g', j) nodes
+    parent: Dict[Tuple[str, int], Tuple[str, int]] = {}
+
+    def find(x):
+        parent.setdefault(x, x)
+        while parent[x] != x:
+            parent[x] = parent[parent[x]]
+            x = parent[x]
+        return x
+
+    for p_idx, g_idx, _ in edges:
+        parent[find(('p', p_idx))] = find(('g', g_idx))
+
+    components: Dict[Tuple[str, int], List[Tuple[int, int, float]]] = {}
+    for edge in edges:
+        components.setdefault(find(('p', edge[0])), []).append(edge)
+
+    matched = []
+    for comp_edges in components.values():
+        if len(comp_edges) == 1:
+            matched.append(comp_edges[0])
+            continue
+        rows = sorted(set(e[0] for e in comp_edges))
+        cols = sorted(set(e[1] for e in comp_edges))
+        transpose = len(rows) > len(cols)
+        if transpose:
+            rows, cols = cols, rows
+        row_pos = {r: i for i, r in enumerate(rows)}
+        col_pos = {c: j for j, c in enumerate(cols)}
+        # A valid pair is worth bonus + iou. The IoU of any matching sums to at most
+        # len(rows) < bonus, so one more match always outweighs any IoU gain.
+        bonus = len(rows) + 1.0
+        cost = [[0.0] * len(cols) for _ in rows]
+        weight = {}
+        for p_idx, g_idx, iou in comp_edges:
+            r, c = (g_idx, p_idx) if transpose else (p_idx, g_idx)
+            cost[row_pos[r]][col_pos[c]] = -(bonus + iou)
+            weight[(r, c)] = iou
+        for r_i, c_j in enumerate(_hungarian_min(cost)):
+            key = (rows[r_i], cols[c_j])
+            if c_j >= 0 and key in weight:
+                p_idx, g_idx = (key[1], key[0]) if transpose else key
+                matched.append((p_idx, g_idx, weight[key]))
+    return matched
+
+def match_regions(pairs: Sequence[Tuple[float, int, int]], iou_threshold: float, matching: str = 'greedy') -> List[Tuple[int, int, float]]:
+    """One-to-one (pred_idx, gt_idx, iou) matches at the given IoU threshold."""
+    if matching == 'hungarian':
+        return _match_hungarian(pairs, iou_threshold)
+    return _match_greedy(pairs, iou_threshold)
+
+def _hmean(precision: float, recall: float) -> float:
+    return 2 * precision * recall / (precision + recall) if (precision + recall) > 0 else 0.0
+
+def calculate_detection_metrics(gt_boxes: Sequence, pred_boxes: Sequence,
+                                iou_thresholds: Sequence[float] = (0.5,),
+                                matching: str = 'greedy') -> Dict:
+    """
+    Polygon IoU detection precision/recall/H-mean, one entry per IoU threshold.
+    """
+    gts = [_Region(b) for b in gt_boxes]
+    preds = [_Region(b) for b in pred_boxes]
+    pairs = _candidate_pairs(preds, gts)
+
+    by_threshold = {}
+    for threshold in iou_thresholds:
+        tp = len(match_regions(pairs, threshold, matching))
+        recall = tp / len(gts) if gts else 1.0
+        precision = tp / len(preds) if preds else (1.0 if not gts else 0.0)
+        by_threshold[f'{threshold:g}'] = {
+            'precision': precision,
+            'recall': recall,
+            'hmean': _hmean(precision, recall),
+            'true_positives': tp
+        }
+    return {
+        'gt_regions': len(gts),
+        'pred_regions': len(preds),
+        'by_iou': by_threshold
+    }
+
+def _line_character_accuracy(reference: str, hypothesis: str) -> float:
+    ref_norm = normalize_text_research_standard(reference)
+    hyp_norm = normalize_text_research_standard(hypothesis)
+    if not ref_norm:
+        return 1.0 if not hyp_norm else 0.0
+    return max(0.0, 1.0 - levenshtein_edit_counts(ref_norm, hyp_norm)['distance'] / len(ref_norm))
+
+def calculate_end_to_end_metrics(gt_lines: Sequence[Dict], pred_boxes: Sequence, pred_texts: Sequence[str],
+                                 iou_threshold: float = 0.5, matching: str = 'greedy') -> Dict:
+    """
+    Per-line end-to-end accuracy. Predicted lines are paired with ground truth lines
+    by polygon IoU; a pair counts as an end-to-end hit when the normalized texts are
+    equal. Unmatched ground truth lines contribute zero line accuracy.
+    """
+    gts = [_Region(line['bbox']) for line in gt_lines]
+    preds = [_Region(b) for b in pred_boxes]
+    matches = match_regions(_candidate_pairs(preds, gts), iou_threshold, matching)
+
+    line_accuracy = [0.0] * len(gts)
+    hits = 0
+    for p_idx, g_idx, _ in matches:
+        acc = _line_character_accuracy(gt_lines[g_idx].get('text', ''), pred_texts[p_idx])
+        line_accuracy[g_idx] = acc
+        if acc == 1.0:
+            hits += 1
+
+    recall = hits / len(gts) if gts else 1.0
+    precision = hits / len(preds) if preds else (1.0 if not gts else 0.0)
+    return {
+        'line_accuracy': sum(line_accuracy) / len(line_accuracy) if line_accuracy else 1.0,
+        'exact_lines': hits,
+        'precision': precision,
+        'recall': recall,
+        'hmean': _hmean(precision, recall)
     }
 
-def calculate_research_standard_accuracy(ground_truth: Dict, ocr_result: Dict, debug: bool = False) -> Dict:
+def calculate_research_standard_accuracy(ground_truth: Dict, ocr_result: Dict, debug: bool = False,
+                                         iou_thresholds: Sequence[float] = (0.5,),
+                                         matching: str = 'greedy') -> Dict:
     """
     Calculate OCR accuracy using research-standard methods - UPDATED for custom dataset format
     """
@@ -152,12 +538,18 @@ def calculate_research_standard_accuracy(ground_truth: Dict, ocr_result: Dict, d
     pred_norm = normalize_text_research_standard(pred_combined)
     exact_match = 1.0 if gt_norm == pred_norm else 0.0
     
-    # Calculate detection metrics
-    gt_regions = len(gt_texts)
-    detected_regions = len(pred_texts)
-    
-    detection_recall = min(detected_regions / gt_regions, 1.0) if gt_regions > 0 else 1.0
-    detection_precision = min(gt_regions / detected_regions, 1.0) if detected_regions > 0 else 0.0
+    # Calculate detection metrics from the labelled quads (only when every line carries one)
+    gt_lines = ground_truth.get('document', [])
+    detection = None
+    end_to_end = None
+    if gt_lines and all('bbox' in item for item in gt_lines):
+        detection = calculate_detection_metrics([item['bbox'] for item in gt_lines],
+                                                ocr_result.get('dt_polys', []),
+                                                iou_thresholds, matching)
+        # rec_polys is aligned with rec_texts (dt_polys also keeps low-score lines)
+        end_to_end = calculate_end_to_end_metrics(gt_lines,
+                                                  ocr_result.get('rec_polys', []),
+                                                  pred_texts, iou_thresholds[0], matching)
     
     # Calculate F1 score for overall text similarity (research standard)
     if char_metrics['ref_length'] > 0 and char_metrics['hyp_length'] > 0:
@@ -167,7 +559,7 @@ def calculate_research_standard_accuracy(ground_truth: Dict, ocr_result: Dict, d
     else:
         f1_score = 0.0
     
-    return {
+    metrics = {
         # ONLY Character Accuracy - simplified output
         'character_accuracy': char_metrics['accuracy'],
         'character_error_rate': char_metrics['cer'],
@@ -177,8 +569,24 @@ def calculate_research_standard_accuracy(ground_truth: Dict, ocr_result: Dict, d
         'hypothesis_length': char_metrics['hyp_length'],
         'substitutions': char_metrics['substitutions'],
         'insertions': char_metrics['insertions'],
-        'deletions': char_metrics['deletions']
+        'deletions': char_metrics['deletions'],
+        'exact_match': exact_match
     }
+    if detection is not None:
+        metrics['detection'] = detection
+        metrics['end_to_end'] = end_to_end
+    return metrics
+
+def ground_truth_document(items: List[Dict]) -> Dict:
+    """Convert one labels.json entry to the expected {'document': [...]} format"""
+    texts = []
+    for item in items:
+        if 'text' in item:
+            line = {'text': item['text']}
+            if 'bbox' in item:
+                line['bbox'] = item['bbox']
+            texts.append(line)
+    return {'document': texts}
 
 def load_ground_truth_for_image(ground_truth_file: str, image_name: str) -> Optional[Dict]:
     """Load ground truth data for a specific image - UPDATED for custom dataset format"""
@@ -188,13 +596,7 @@ def load_ground_truth_for_image(ground_truth_file: str, image_name: str) -> Opti
         
         # Custom dataset format: direct image name keys
         if image_name in gt_data:
-            # Convert custom format to expected format
-            texts = []
-            for item in gt_data[image_name]:
-                if 'text' in item:
-                    texts.append({'text': item['text']})
-            
-            return {'document': texts}
+            return ground_truth_document(gt_data[image_name])
         
         print(f"Warning: Ground truth not found for image: {image_name}")
         return None
@@ -223,23 +625,337 @@ def load_ocr_result_for_image(output_dir: str, image_name: str) -> Optional[Dict
         print(f"Error loading OCR result: {e}")
         return None
 
-def calculate_accuracy():
+def load_perf_for_image(output_dir: str, image_name: str) -> Optional[Dict]:
+    """Load the timing sidecar (<name>_perf.json) the Benchmark writes next to each result"""
+    perf_path = os.path.join(output_dir, f"{os.path.splitext(image_name)[0]}_perf.json")
+    try:
+        with open(perf_path, 'r', encoding='utf-8') as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+def _rec_input_width(region: _Region, rec_height: int = 48) -> float:
+    """Width of the crop once rec resizes it to a fixed height; rec cost grows with it."""
+    width = region.x1 - region.x0
+    height = region.y1 - region.y0
+    if len(region.hull) >= 4:
+        # Rotated quads: use the rectified side lengths instead of the axis-aligned box
+        (ax, ay), (bx, by), (cx, cy) = region.hull[0], region.hull[1], region.hull[2]
+        side_a = ((bx - ax) ** 2 + (by - ay) ** 2) ** 0.5
+        side_b = ((cx - bx) ** 2 + (cy - by) ** 2) ** 0.5
+        width, height = max(side_a, side_b), min(side_a, side_b)
+    return width * rec_height / height if height > 0 else 0.0
+
+def analyze_image_lines(image_name: str, ground_truth: Dict, ocr_result: Dict, page_metrics: Dict,
+                        perf: Optional[Dict], iou_threshold: float = 0.5,
+                        matching: str = 'greedy') -> Tuple[List[Dict], Dict]:
     """
-    This function is now a placeholder. The main logic is handled in startup.sh
-    which processes all images and then calls this script for each one.
-    This script is now focused on single-image calculation.
+    Align predicted and ground truth lines by bbox and describe every line:
+    matched pairs with their edit counts, missed ground truth lines and spurious
+    predictions. Each predicted line also gets page_time_proxy_ms, a page-time
+    proxy: the whole-page inference time (every stage, not just rec) split by the
+    line's share of rec input width. The pipeline does not report rec time per
+    batch, so this only ranks lines within a page; it is not the line's rec time.
     """
-    pass
+    gt_lines = ground_truth.get('document', [])
+    pred_polys = ocr_result.get('rec_polys', [])
+    pred_texts = ocr_result.get('rec_texts', [])
+    pred_scores = ocr_result.get('rec_scores', [])
+    gts = [_Region(line['bbox']) for line in gt_lines if 'bbox' in line]
+    preds = [_Region(p) for p in pred_polys]
+    if len(gts) != len(gt_lines):
+        gts = []
+
+    inference_ms = perf.get('inference_ms') if perf else None
+    widths = [_rec_input_width(p) for p in preds]
+    total_width = sum(widths)
+
+    def pred_fields(p_idx: int) -> Dict:
+        region = preds[p_idx]
+        fields = {
+            'pred_index': p_idx,
+            'pred_text': pred_texts[p_idx] if p_idx < len(pred_texts) else '',
+            'rec_score': pred_scores[p_idx] if p_idx < len(pred_scores) else None,
+            'crop': [round(region.x0), round(region.y0), round(region.x1), round(region.y1)],
+            'pred_poly': pred_polys[p_idx],
+            'rec_width': round(widths[p_idx], 1)
+        }
+        if inference_ms is not None and total_width > 0:
+            fields['page_time_proxy_ms'] = inference_ms * widths[p_idx] / total_width
+        return fields
+
+    lines: List[Dict] = []
+    matched_pred = set()
+    matched_gt = set()
+    for p_idx, g_idx, iou in match_regions(_candidate_pairs(preds, gts), iou_threshold, matching):
+        matched_pred.add(p_idx)
+        matched_gt.add(g_idx)
+        gt_text = gt_lines[g_idx].get('text', '')
+        record = {'image_name': image_name, 'status': 'matched', 'gt_index': g_idx,
+                  'gt_text': gt_text, 'iou': iou}
+        record.update(pred_fields(p_idx))
+        ref_norm = normalize_text_research_standard(gt_text)
+        hyp_norm = normalize_text_research_standard(record['pred_text'])
+        record.update(levenshtein_edit_counts(ref_norm, hyp_norm))
+        record['line_accuracy'] = _line_character_accuracy(gt_text, record['pred_text'])
+        lines.append(record)
+    for g_idx, region in enumerate(gts):
+        if g_idx not in matched_gt:
+            lines.append({'image_name': image_name, 'status': 'missed', 'gt_index': g_idx,
+                          'gt_text': gt_lines[g_idx].get('text', ''),
+                          'crop': [round(region.x0), round(region.y0), round(region.x1), round(region.y1)]})
+    for p_idx in range(len(preds)):
+        if p_idx not in matched_pred:
+            record = {'image_name': image_name, 'status': 'spurious'}
+            record.update(pred_fields(p_idx))
+            lines.append(record)
+
+    # Characters the page alignment got right: reference minus substitutions and deletions
+    correct_chars = page_metrics['reference_length'] - page_metrics['substitutions'] - page_metrics['deletions']
+    summary = {
+        'image_name': image_name,
+        'inference_ms': inference_ms,
+        'correct_chars': correct_chars,
+        'character_accuracy': page_metrics['character_accuracy'],
+        'ms_per_correct_char': (inference_ms / correct_chars
+                                if inference_ms is not None and correct_chars > 0 else None),
+        'error_lines': sum(1 for l in lines if l['status'] != 'matched' or l['distance'] > 0)
+    }
+    return lines, summary
+
+def rank_images_by_cost(summaries: Sequence[Dict]) -> List[Dict]:
+    """Most expensive first; images with no correct characters (or no timing) go last."""
+    timed = [s for s in summaries if s['ms_per_correct_char'] is not None]
+    untimed = [s for s in summaries if s['ms_per_correct_char'] is None]
+    return sorted(timed, key=lambda s: -s['ms_per_correct_char']) + untimed
+
+def write_line_analysis(path: str, lines: Sequence[Dict], ranking: Sequence[Dict], top: int):
+    with open(path, 'w', encoding='utf-8') as f:
+        for record in lines:
+            f.write(json.dumps(record, ensure_ascii=False) + '\n')
+
+    report = f"""
+========================================
+PER-LINE ERROR ANALYSIS
+========================================
+Lines written: {len(lines)} -> {path}
+Images ranked by ms per correctly recognized character:
+"""
+    for summary in ranking[:top]:
+        cost = summary['ms_per_correct_char']
+        cost_str = f"{cost:.3f} ms/char" if cost is not None else "n/a"
+        report += (f"  {summary['image_name']}: {cost_str}, accuracy {summary['character_accuracy']*100:.2f}%, "
+                   f"{summary['correct_chars']} correct chars, {summary['error_lines']} error lines\n")
+    report += "========================================\n"
+    print(report, file=sys.stderr)
+
+# Shared with forked evaluation workers (copy-on-write), so labels.json is parsed once
+_DATASET_CONTEXT: Dict = {}
+
+def _evaluate_dataset_image(image_name: str) -> Tuple[str, Optional[Dict]]:
+    ctx = _DATASET_CONTEXT
+    ocr_path = os.path.join(ctx['output_dir'], f"{os.path.splitext(image_name)[0]}_res.json")
+    try:
+        with open(ocr_path, 'r', encoding='utf-8') as f:
+            ocr_data = json.load(f)
+    except (OSError, ValueError):
+        return image_name, None
+    gt_data = ground_truth_document(ctx['labels'][image_name])
+    metrics = calculate_research_standard_accuracy(gt_data, ocr_data,
+                                                   iou_thresholds=ctx['iou_thresholds'],
+                                                   matching=ctx['matching'])
+    if ctx.get('analysis'):
+        perf = load_perf_for_image(ctx['output_dir'], image_name)
+        metrics['analysis'] = analyze_image_lines(image_name, gt_data, ocr_data, metrics, perf,
+                                                  ctx['iou_thresholds'][0], ctx['matching'])
+    return image_name, metrics
+
+def aggregate_dataset_metrics(per_image: Dict[str, Dict]) -> Dict:
+    """
+    Micro averages pool the counts of every image (long pages weigh more),
+    macro averages give every image the same weight.
+    """
+    count = len(per_image)
+    if count == 0:
+        return {'images': 0}
+    metrics = list(per_image.values())
+    ref_total = sum(m['reference_length'] for m in metrics)
+    edit_total = sum(m['substitutions'] + m['insertions'] + m['deletions'] for m in metrics)
+    micro_cer = edit_total / ref_total if ref_total > 0 else 0.0
+    result = {
+        'images': count,
+        'micro_character_error_rate': micro_cer,
+        'micro_character_accuracy': max(0.0, 1.0 - micro_cer),
+        'macro_character_error_rate': sum(m['character_error_rate'] for m in metrics) / count,
+        'macro_character_accuracy': sum(m['character_accuracy'] for m in metrics) / count,
+        'exact_match_rate': sum(m['exact_match'] for m in metrics) / count,
+        'reference_length': ref_total
+    }
+
+    with_det = [m for m in metrics if 'detection' in m]
+    if with_det:
+        detection = {}
+        for threshold in with_det[0]['detection']['by_iou']:
+            tp = sum(m['detection']['by_iou'][threshold]['true_positives'] for m in with_det)
+            gts = sum(m['detection']['gt_regions'] for m in with_det)
+            preds = sum(m['detection']['pred_regions'] for m in with_det)
+            precision = tp / preds if preds else (1.0 if not gts else 0.0)
+            recall = tp / gts if gts else 1.0
+            detection[threshold] = {
+                'micro_precision': precision,
+                'micro_recall': recall,
+                'micro_hmean': _hmean(precision, recall),
+                'macro_hmean': sum(m['detection']['by_iou'][threshold]['hmean'] for m in with_det) / len(with_det)
+            }
+        gt_lines = sum(m['detection']['gt_regions'] for m in with_det)
+        result['detection'] = detection
+        result['end_to_end'] = {
+            'micro_line_accuracy': (sum(m['end_to_end']['line_accuracy'] * m['detection']['gt_regions'] for m in with_det) / gt_lines
+                                    if gt_lines else 1.0),
+            'macro_line_accuracy': sum(m['end_to_end']['line_accuracy'] for m in with_det) / len(with_det),
+            'macro_hmean': sum(m['end_to_end']['hmean'] for m in with_det) / len(with_det)
+        }
+    return result
+
+def calculate_accuracy(ground_truth_file: str, output_dir: str, workers: int = 0,
+                       iou_thresholds: Sequence[float] = (0.5,), matching: str = 'greedy',
+                       analysis: bool = False,
+                       images: Optional[Sequence[str]] = None) -> Tuple[Dict[str, Dict], List[str]]:
+    """
+    Whole-dataset evaluation pass, decoupled from the timed benchmark loop.
+    Every labelled image that has a *_res.json in output_dir is scored in a pool
+    of worker processes; with `images` (the run's manifest) only those names are,
+    so results left over from earlier runs never enter the means.
+    Returns (per-image metrics, images without a result).
+    With analysis=True each metrics dict also carries an 'analysis' entry
+    (per-line records, image summary) from analyze_image_lines.
+    """
+    with open(ground_truth_file, 'r', encoding='utf-8') as f:
+        labels = json.load(f)
+    _DATASET_CONTEXT.update(labels=labels, output_dir=output_dir,
+                            iou_thresholds=list(iou_thresholds), matching=matching,
+                            analysis=analysis)
+
+    image_names = sorted(labels.keys())
+    if images is not None:
+        wanted = set(images)
+        image_names = [name for name in image_names if name in wanted]
+    workers = workers if workers > 0 else (os.cpu_count() or 1)
+    workers = min(workers, max(1, len(image_names)))
+    # Small chunks keep long pages from piling up on one worker; large chunks amortize IPC
+    chunksize = max(1, min(64, len(image_names) // (workers * 8)))
+
+    per_image: Dict[str, Dict] = {}
+    missing: List[str] = []
+
+    def collect(results):
+        for image_name, metrics in results:
+            if metrics is None:
+                missing.append(image_name)
+            else:
+                per_image[image_name] = metrics
+
+    if workers == 1:
+        collect(map(_evaluate_dataset_image, image_names))
+    else:
+        methods = multiprocessing.get_all_start_methods()
+        ctx = multiprocessing.get_context('fork' if 'fork' in methods else None)
+        with ctx.Pool(workers) as pool:
+            collect(pool.imap_unordered(_evaluate_dataset_image, image_names, chunksize))
+    return per_image, sorted(missing)
+
+def analysis_path(args) -> str:
+    return args.analysis_file or os.path.join(args.output_dir, 'line_analysis.jsonl')
+
+def load_image_manifest(path: str) -> List[str]:
+    """Image file names to score, one per line (blank lines ignored)."""
+    with open(path, 'r', encoding='utf-8') as f:
+        return [line.strip() for line in f if line.strip()]
+
+def score_line_pairs(path: str):
+    """
+    Character accuracy of text pairs that are already aligned (e.g. cropped fields),
+    with the same normalization as the page metrics. Reads JSON lines with
+    "reference" and "hypothesis" and prints one LINE_ACC line per pair, in order.
+    """
+    with open(path, 'r', encoding='utf-8') as f:
+        for index, line in enumerate(l for l in f if l.strip()):
+            record = json.loads(line)
+            acc = _line_character_accuracy(record.get('reference', ''), record.get('hypothesis', ''))
+            print(f"LINE_ACC: {json.dumps({'index': index, 'character_accuracy': acc})}")
+
+def run_dataset_evaluation(args, iou_thresholds: List[float]):
+    images = load_image_manifest(args.images) if args.images else None
+    per_image, missing = calculate_accuracy(args.ground_truth, args.output_dir, args.workers,
+                                            iou_thresholds, args.matching, args.analysis, images)
+    if args.analysis:
+        lines: List[Dict] = []
+        summaries: List[Dict] = []
+        for image_name in sorted(per_image):
+            image_lines, summary = per_image[image_name].pop('analysis')
+            lines.extend(image_lines)
+            summaries.append(summary)
+        write_line_analysis(analysis_path(args), lines, rank_images_by_cost(summaries), args.top)
+
+    aggregate = aggregate_dataset_metrics(per_image)
+    aggregate['missing_results'] = len(missing)
+
+    for image_name in sorted(per_image):
+        record = dict(per_image[image_name])
+        record['image_name'] = image_name
+        print(f"IMAGE_ACC: {json.dumps(record, ensure_ascii=False)}")
+
+    summary = f"""
+========================================
+DATASET ACCURACY EVALUATION
+========================================
+Images evaluated: {aggregate['images']} (missing results: {len(missing)})
+"""
+    if aggregate['images'] > 0:
+        summary += f"""Character Accuracy (micro/macro): {aggregate['micro_character_accuracy']*100:.2f}% / {aggregate['macro_character_accuracy']*100:.2f}%
+Character Error Rate (micro/macro): {aggregate['micro_character_error_rate']*100:.2f}% / {aggregate['macro_character_error_rate']*100:.2f}%
+Exact Match Rate: {aggregate['exact_match_rate']*100:.2f}%
+"""
+        for threshold, det in aggregate.get('detection', {}).items():
+            summary += f"Detection H-mean @IoU {threshold} (micro/macro): {det['micro_hmean']*100:.2f}% / {det['macro_hmean']*100:.2f}%\n"
+    summary += "========================================\n"
+    print(summary, file=sys.stderr)
+
+    if args.results_file:
+        with open(args.results_file, 'w', encoding='utf-8') as f:
+            json.dump({'aggregate': aggregate, 'per_image': per_image, 'missing': missing},
+                      f, ensure_ascii=False, indent=2)
+
+    print(f"DATASET_ACC: {json.dumps(aggregate, ensure_ascii=False)}")
 
 def main():
-    parser = argparse.ArgumentParser(description='Calculate OCR accuracy for a single image')
+    parser = argparse.ArgumentParser(description='Calculate OCR accuracy for a single image or a whole dataset')
     parser.add_argument('--ground_truth', required=True, help='Path to the master ground truth JSON file (e.g., labels.json)')
     parser.add_argument('--output_dir', required=True, help='Directory containing OCR output JSON files')
-    parser.add_argument('--image_name', required=True, help='The specific image file name to process (e.g., image_0.png)')
+    parser.add_argument('--image_name', help='The specific image file name to process (e.g., image_0.png)')
+    parser.add_argument('--all', action='store_true', help='Evaluate every labelled image found in output_dir in parallel')
+    parser.add_argument('--line_pairs', help='Score aligned reference/hypothesis pairs from this JSON lines file instead of images')
+    parser.add_argument('--images', help='With --all, score only the image names listed in this file (one per line)')
+    parser.add_argument('--workers', type=int, default=0, help='Worker processes for --all (default: all cores)')
     parser.add_argument('--debug', action='store_true', help='Enable debug mode to print raw and normalized texts')
-    parser.add_argument('--results_file', help=argparse.SUPPRESS) # Suppress help for this unused arg
+    parser.add_argument('--iou_thresholds', default='0.5', help='Comma separated IoU thresholds for detection H-mean (e.g., 0.5,0.7)')
+    parser.add_argument('--matching', choices=['greedy', 'hungarian'], default='greedy', help='Box assignment used for IoU matching')
+    parser.add_argument('--results_file', help='With --all, also write per-image and aggregate metrics to this JSON file')
+    parser.add_argument('--analysis', action='store_true', help='Align lines by bbox and write per-line errors plus an image cost ranking')
+    parser.add_argument('--analysis_file', help='JSON lines output for --analysis (default: <output_dir>/line_analysis.jsonl)')
+    parser.add_argument('--top', type=int, default=10, help='Number of ranked images printed by --analysis')
 
     args = parser.parse_args()
+    if not args.all and not args.image_name and not args.line_pairs:
+        parser.error('one of --image_name, --all or --line_pairs is required')
+    iou_thresholds = [float(t) for t in args.iou_thresholds.split(',') if t.strip()] or [0.5]
+
+    if args.line_pairs:
+        score_line_pairs(args.line_pairs)
+        return
+    if args.all:
+        run_dataset_evaluation(args, iou_thresholds)
+        return
 
     # Load the specific ground truth document for the given image
     gt_data = load_ground_truth_for_image(args.ground_truth, args.image_name)
@@ -258,7 +974,9 @@ def main():
         sys.exit(1)
 
     # Calculate the accuracy metrics
-    accuracy_metrics = calculate_research_standard_accuracy(gt_data, ocr_data, debug=args.debug)
+    accuracy_metrics = calculate_research_standard_accuracy(gt_data, ocr_data, debug=args.debug,
+                                                            iou_thresholds=iou_thresholds,
+                                                            matching=args.matching)
 
     # Print a clean, human-readable summary to stderr for immediate feedback in the log
     summary = f"""
@@ -269,10 +987,21 @@ Image: {args.image_name}
 Character Accuracy: {accuracy_metrics['character_accuracy']*100:.2f}%
 Character Error Rate: {accuracy_metrics['character_error_rate']*100:.2f}%
 Ref Length: {accuracy_metrics['reference_length']}, Hyp Length: {accuracy_metrics['hypothesis_length']}
-========================================
 """
+    if 'detection' in accuracy_metrics:
+        for threshold, det in accuracy_metrics['detection']['by_iou'].items():
+            summary += f"Detection @IoU {threshold}: P {det['precision']*100:.2f}% R {det['recall']*100:.2f}% H-mean {det['hmean']*100:.2f}%\n"
+        e2e = accuracy_metrics['end_to_end']
+        summary += f"End-to-end line accuracy: {e2e['line_accuracy']*100:.2f}% (exact lines: {e2e['exact_lines']}, H-mean {e2e['hmean']*100:.2f}%)\n"
+    summary += "========================================\n"
     print(summary, file=sys.stderr)
 
+    if args.analysis:
+        perf = load_perf_for_image(args.output_dir, args.image_name)
+        lines, image_summary = analyze_image_lines(args.image_name, gt_data, ocr_data, accuracy_metrics, perf,
+                                                   iou_thresholds[0], args.matching)
+        write_line_analysis(analysis_path(args), lines, [image_summary], args.top)
+
     # Print the machine-readable JSON to stdout, prefixed for easy parsing by the C++ app
     print(f"SINGLE_ACC: {json.dumps(accuracy_metrics, ensure_ascii=False)}")
 
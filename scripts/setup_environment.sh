@@ -456,7 +456,6 @@ configure_pip() {
         # Install required Python packages for OCR accuracy calculation
         log_info "Installing required Python packages..."
         local required_packages=(
-            "jiwer"
             "numpy"
             "opencv-python"
         )
@@ -45,14 +45,6 @@ if [[ "$CONDA_DEFAULT_ENV" != "deepx" ]]; then
 fi
 log "✓ Conda environment activated: $CONDA_DEFAULT_ENV"
 
-# Ensure required Python packages are installed
-log "Checking required Python packages..."
-if ! python -c "import jiwer" 2>/dev/null; then
-    log "Installing jiwer package for accuracy calculation..."
-    pip install jiwer
-fi
-log "✓ Required Python packages verified"
-
 # Set library paths for runtime
 export LD_LIBRARY_PATH="$CONDA_PREFIX/lib:$LD_LIBRARY_PATH"
 log "✓ Library paths configured: $LD_LIBRARY_PATH"
@@ -76,6 +68,7 @@ cd "$PROJECT_ROOT"
 # Check if we need to build or rebuild
 NEED_BUILD=false
 FORCE_REBUILD="${FORCE_REBUILD:-false}"
+BENCHMARK_ARGS="${BENCHMARK_ARGS:-}"
 
 if [[ "$FORCE_REBUILD" == "true" ]]; then
     log "Force rebuild requested"
@@ -86,7 +79,7 @@ elif [[ ! -d "$BUILD_DIR" ]]; then
 elif [[ ! -f "$BUILD_DIR/Benchmark" ]]; then
     log "Benchmark executable not found"
     NEED_BUILD=true
-elif [[ "$BUILD_DIR/Benchmark" -ot "src/Benchmark.cpp" ]]; then
+elif [[ -n "$(find src -newer "$BUILD_DIR/Benchmark" -print -quit)" ]]; then
     log "Source code is newer than executable"
     NEED_BUILD=true
 elif [[ "$BUILD_DIR/Benchmark" -ot "CMakeLists.txt" ]]; then
@@ -390,7 +383,7 @@ run_batch_benchmark() {
     local benchmark_start=$(date +%s.%N)
     
     log "=== Starting Benchmark Executable ==="
-    log "Command: $BUILD_DIR/Benchmark $images_dir"
+    log "Command: $BUILD_DIR/Benchmark $BENCHMARK_ARGS $images_dir"
     log "Environment variables:"
     log "  LD_LIBRARY_PATH: $LD_LIBRARY_PATH"
     log "  CONDA_DEFAULT_ENV: $CONDA_DEFAULT_ENV"
@@ -400,7 +393,7 @@ run_batch_benchmark() {
     echo "========================================================================"
     
     # Run benchmark in background and monitor progress
-    "$BUILD_DIR/Benchmark" "$images_dir" > "$results_dir/benchmark_output.log" 2>&1 &
+    "$BUILD_DIR/Benchmark" $BENCHMARK_ARGS "$images_dir" > "$results_dir/benchmark_output.log" 2>&1 &
     local benchmark_pid=$!
     
     # Monitor progress by tailing the log file for specific progress lines
@@ -623,6 +616,7 @@ Results are saved to: output/batch_results_TIMESTAMP/
 
 Environment variables:
   FORCE_REBUILD=true     # Force a complete rebuild
+  BENCHMARK_ARGS="..."   # Extra Benchmark options, e.g. "--deferred_accuracy"
 EOF
         exit 1
         ;;
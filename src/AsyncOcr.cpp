@@ -0,0 +1,132 @@
+#include "AsyncOcr.h"
+#include "BenchmarkUtils.h"
+#include "ReplayBenchmark.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+AsyncOcr::AsyncOcr(const std::vector<PaddleOCR*>& engines, size_t max_pending) : queue_(max_pending) {
+    if (engines.empty()) {
+        throw std::runtime_error("AsyncOcr needs at least one engine");
+    }
+    for (PaddleOCR* engine : engines) {
+        workers_.push_back(std::thread(&AsyncOcr::WorkerLoop, this, engine));
+    }
+}
+
+AsyncOcr::~AsyncOcr() {
+    queue_.Close();
+    for (auto& worker : workers_) worker.join();
+}
+
+std::future<std::vector<std::unique_ptr<BaseCVResult> > > AsyncOcr::PredictAsync(const std::string& image_path) {
+    // std::function needs a copyable target, so the promise is shared
+    std::shared_ptr<std::promise<std::vector<std::unique_ptr<BaseCVResult> > > > promise(
+        new std::promise<std::vector<std::unique_ptr<BaseCVResult> > >());
+    std::future<std::vector<std::unique_ptr<BaseCVResult> > > result = promise->get_future();
+    PredictAsync(image_path, [promise](AsyncPrediction& prediction) {
+        if (prediction.error) {
+            promise->set_exception(prediction.error);
+        } else {
+            promise->set_value(std::move(prediction.outputs));
+        }
+    });
+    return result;
+}
+
+void AsyncOcr::PredictAsync(const std::string& image_path, PredictCallback on_done) {
+    Task task;
+    task.image_path = image_path;
+    task.on_done = on_done;
+    task.submitted = std::chrono::steady_clock::now();
+    if (!queue_.Push(std::move(task))) {
+        throw std::runtime_error("AsyncOcr is shutting down");
+    }
+}
+
+void AsyncOcr::WorkerLoop(PaddleOCR* engine) {
+    Task task;
+    while (queue_.Pop(&task)) {
+        AsyncPrediction prediction;
+        prediction.image_path = task.image_path;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        prediction.queue_ms = elapsedMs(task.submitted, start);
+        try {
+            prediction.outputs = engine->Predict(task.image_path);
+        } catch (...) {
+            prediction.error = std::current_exception();
+        }
+        prediction.predict_ms = elapsedMs(start, std::chrono::steady_clock::now());
+        try {
+            task.on_done(prediction);
+        } catch (const std::exception& e) {
+            std::cerr << "  [ERROR] PredictAsync callback for " << task.image_path << " threw: " << e.what() << std::endl;
+        }
+    }
+}
+
+std::vector<AsyncDepthPoint> runAsyncDepthSweep(const std::vector<std::string>& images,
+                                                AsyncOcr& ocr,
+                                                const std::vector<int>& depths) {
+    std::vector<AsyncDepthPoint> points;
+    if (images.empty()) return points;
+
+    for (int depth : depths) {
+        AsyncDepthPoint point;
+        point.depth = std::max(1, depth);
+        point.requests = static_cast<int>(std::max(images.size(), static_cast<size_t>(2 * point.depth)));
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        int in_flight = 0;
+        int done = 0;
+        int lowest_pending = 0; // smallest submission index not completed yet
+        std::vector<bool> completed(point.requests, false);
+        std::vector<double> latencies;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < point.requests; i++) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return in_flight < point.depth; });
+                in_flight++;
+            }
+            std::chrono::steady_clock::time_point submitted = std::chrono::steady_clock::now();
+            ocr.PredictAsync(images[i % images.size()], [&, i, submitted](AsyncPrediction& prediction) {
+                double latency = elapsedMs(submitted, std::chrono::steady_clock::now());
+                std::lock_guard<std::mutex> lock(mutex);
+                if (prediction.error) point.failed++;
+                if (i > lowest_pending) point.out_of_order++;
+                completed[i] = true;
+                while (lowest_pending < point.requests && completed[lowest_pending]) lowest_pending++;
+                latencies.push_back(latency);
+                in_flight--;
+                done++;
+                changed.notify_all();
+            });
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return done == point.requests; });
+        }
+        point.wall_ms = elapsedMs(start, std::chrono::steady_clock::now());
+        point.throughput = point.wall_ms > 0 ? point.requests * 1000.0 / point.wall_ms : 0.0;
+        point.p50_ms = percentile(latencies, 50);
+        point.p99_ms = percentile(latencies, 99);
+
+        std::cout << "ASYNC_RESULT:{\"depth\":" << point.depth
+                  << ",\"workers\":" << ocr.Workers()
+                  << ",\"requests\":" << point.requests
+                  << ",\"failed\":" << point.failed
+                  << ",\"throughput_rps\":" << std::fixed << std::setprecision(2) << point.throughput
+                  << ",\"p50_ms\":" << point.p50_ms
+                  << ",\"p99_ms\":" << point.p99_ms
+                  << ",\"out_of_order\":" << point.out_of_order << "}" << std::endl;
+        points.push_back(point);
+    }
+    return points;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include "BoundedQueue.h"
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Completion of one PredictAsync call, handed to the callback on the worker thread
+struct AsyncPrediction {
+    std::string image_path;
+    std::vector<std::unique_ptr<BaseCVResult> > outputs; // what Predict returned; the callback may move them out
+    std::exception_ptr error;                            // set when Predict threw
+    double queue_ms = 0.0;                               // submission to start of Predict
+    double predict_ms = 0.0;
+};
+
+typedef std::function<void(AsyncPrediction&)> PredictCallback;
+
+// Non-blocking front end over PaddleOCR::Predict. Requests go into one bounded
+// queue served by a thread per engine (PaddleOCR instances are not shared
+// between threads), so callers keep many requests in flight without a
+// thread each. Completions arrive in whatever order the workers finish.
+class AsyncOcr {
+public:
+    // engines stay owned by the caller and must outlive this object. max_pending
+    // bounds queued requests; PredictAsync blocks while the queue is full.
+    explicit AsyncOcr(const std::vector<PaddleOCR*>& engines, size_t max_pending = 256);
+
+    // Finishes queued requests, then joins the workers
+    ~AsyncOcr();
+
+    // The future holds Predict's outputs, or rethrows what Predict threw
+    std::future<std::vector<std::unique_ptr<BaseCVResult> > > PredictAsync(const std::string& image_path);
+
+    // on_done runs on a worker thread and must not block for long
+    void PredictAsync(const std::string& image_path, PredictCallback on_done);
+
+    int Workers() const { return static_cast<int>(workers_.size()); }
+
+private:
+    struct Task {
+        std::string image_path;
+        PredictCallback on_done;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    void WorkerLoop(PaddleOCR* engine);
+
+    BoundedQueue<Task> queue_;
+    std::vector<std::thread> workers_;
+};
+
+struct AsyncDepthPoint {
+    int depth = 0;
+    int requests = 0;
+    int failed = 0;
+    int out_of_order = 0; // completions that overtook an earlier submission
+    double wall_ms = 0.0;
+    double throughput = 0.0; // requests/s
+    double p50_ms = 0.0;     // submission to completion
+    double p99_ms = 0.0;
+};
+
+// Keeps `depth` requests in flight over the images (cycled to at least
+// max(images, 2 * depth) requests) for each depth, and prints an
+// ASYNC_RESULT line per depth.
+std::vector<AsyncDepthPoint> runAsyncDepthSweep(const std::vector<std::string>& images,
+                                                AsyncOcr& ocr,
+                                                const std::vector<int>& depths);
@@ -0,0 +1,181 @@
+#include "BatchOcr.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PageStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <utility>
+
+namespace {
+
+void addTiming(const BatchOcrTiming& run, double scale, BatchOcrTiming* total) {
+    total->orientation_ms += run.orientation_ms * scale;
+    total->det_ms += run.det_ms * scale;
+    total->crop_ms += run.crop_ms * scale;
+    total->textline_ms += run.textline_ms * scale;
+    total->rec_ms += run.rec_ms * scale;
+}
+
+bool sameText(const std::vector<OcrLine>& a, const std::vector<OcrLine>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].text != b[i].text) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+BatchOcr::BatchOcr(TextDetector& detector, TextRecognizer& recognizer, TextlineClassifier* textline,
+                   DocPreprocessor* doc_orientation, const DetectorConfig& config)
+    : detector_(detector), recognizer_(recognizer), textline_(textline), doc_orientation_(doc_orientation),
+      config_(config) {}
+
+std::vector<std::vector<OcrLine> > BatchOcr::Predict(const std::vector<cv::Mat>& images) {
+    timing_ = BatchOcrTiming();
+    std::vector<cv::Mat> pages(images);
+
+    if (doc_orientation_ != nullptr) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<int> angles;
+        doc_orientation_->ClassifyPages(pages, &angles);
+        for (size_t i = 0; i < pages.size(); i++) undoPageRotation(&pages[i], angles[i]);
+        timing_.orientation_ms = elapsedMs(start);
+    }
+
+    auto det_start = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<DetectedBox> > boxes;
+    timing_.det_runs = detector_.DetectBatch(pages, config_, &boxes);
+    timing_.det_ms = elapsedMs(det_start);
+
+    // Crops of all pages in one list, remembering which page / box each came from
+    auto crop_start = std::chrono::high_resolution_clock::now();
+    std::vector<cv::Mat> crops;
+    std::vector<std::pair<size_t, size_t> > owners;
+    for (size_t i = 0; i < pages.size(); i++) {
+        for (size_t j = 0; j < boxes[i].size(); j++) {
+            crops.push_back(cropTextRegion(pages[i], boxes[i][j].quad));
+            owners.push_back(std::make_pair(i, j));
+        }
+    }
+    timing_.crop_ms = elapsedMs(crop_start);
+
+    if (textline_ != nullptr) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<bool> flipped;
+        textline_->Classify(crops, &flipped);
+        for (size_t k = 0; k < crops.size(); k++) {
+            if (flipped[k] && !crops[k].empty()) cv::rotate(crops[k], crops[k], cv::ROTATE_180);
+        }
+        timing_.textline_ms = elapsedMs(start);
+    }
+
+    auto rec_start = std::chrono::high_resolution_clock::now();
+    std::vector<RecognizedText> texts;
+    recognizer_.Recognize(crops, &texts);
+    timing_.rec_ms = elapsedMs(rec_start);
+
+    std::vector<std::vector<OcrLine> > results(pages.size());
+    for (size_t i = 0; i < pages.size(); i++) results[i].resize(boxes[i].size());
+    for (size_t k = 0; k < owners.size(); k++) {
+        OcrLine& line = results[owners[k].first][owners[k].second];
+        line.poly = boxes[owners[k].first][owners[k].second].quad;
+        line.text = texts[k].text;
+        line.score = texts[k].score;
+    }
+    return results;
+}
+
+std::vector<std::vector<OcrLine> > BatchOcr::Predict(const std::vector<std::string>& image_paths) {
+    std::vector<cv::Mat> images;
+    DecodedImage decoded;
+    for (const auto& path : image_paths) {
+        if (!decodeImage(path, 0, &decoded)) throw std::runtime_error("cannot decode " + path);
+        images.push_back(decoded.image);
+    }
+    return Predict(images);
+}
+
+void BatchOcr::SetZeroCopy(bool enabled) {
+    detector_.SetZeroCopy(enabled);
+    recognizer_.SetZeroCopy(enabled);
+    if (textline_) textline_->SetZeroCopy(enabled);
+    if (doc_orientation_) doc_orientation_->SetZeroCopy(enabled);
+}
+
+BatchPredictSummary runBatchPredictBenchmark(const std::vector<std::string>& images,
+                                             BatchOcr& ocr,
+                                             int batch_images,
+                                             int runs,
+                                             const std::string& output_dir) {
+    BatchPredictSummary summary;
+    if (runs < 1) runs = 1;
+    if (batch_images < 1) batch_images = 1;
+    mkdir(output_dir.c_str(), 0755);
+
+    for (size_t start = 0; start < images.size(); start += batch_images) {
+        size_t end = std::min(images.size(), start + static_cast<size_t>(batch_images));
+        std::vector<std::string> group(images.begin() + start, images.begin() + end);
+        try {
+            std::vector<cv::Mat> pages;
+            for (const auto& path : group) {
+                DecodedImage decoded;
+                if (!decodeImage(path, 0, &decoded)) throw std::runtime_error("cannot decode " + path);
+                pages.push_back(decoded.image);
+            }
+
+            std::vector<std::vector<OcrLine> > single_results(pages.size());
+            std::vector<std::vector<OcrLine> > batch_results;
+            BatchOcrTiming single, batched;
+            double single_ms = 0.0;
+            double batch_ms = 0.0;
+            int det_runs = 0;
+            for (int run = 0; run < runs; run++) {
+                for (size_t i = 0; i < pages.size(); i++) {
+                    auto single_start = std::chrono::high_resolution_clock::now();
+                    single_results[i] = ocr.Predict(std::vector<cv::Mat>(1, pages[i]))[0];
+                    single_ms += elapsedMs(single_start);
+                    addTiming(ocr.LastTiming(), 1.0 / runs, &single);
+                }
+                auto batch_start = std::chrono::high_resolution_clock::now();
+                batch_results = ocr.Predict(pages);
+                batch_ms += elapsedMs(batch_start);
+                addTiming(ocr.LastTiming(), 1.0 / runs, &batched);
+                det_runs = ocr.LastTiming().det_runs;
+            }
+            single_ms /= runs;
+            batch_ms /= runs;
+
+            int mismatched = 0;
+            for (size_t i = 0; i < group.size(); i++) {
+                saveOcrLines(output_dir + documentStem(group[i]) + "_res.json", group[i], batch_results[i]);
+                if (!sameText(single_results[i], batch_results[i])) mismatched++;
+            }
+
+            summary.images += static_cast<int>(group.size());
+            summary.mismatched_images += mismatched;
+            summary.single_ms += single_ms;
+            summary.batch_ms += batch_ms;
+            addTiming(single, 1.0, &summary.single);
+            addTiming(batched, 1.0, &summary.batched);
+            summary.batched.det_runs += det_runs;
+            summary.single.det_runs += static_cast<int>(group.size());
+
+            std::cout << "BATCH_PREDICT_RESULT:{\"first\":\"" << group.front().substr(group.front().find_last_of('/') + 1)
+                      << "\",\"images\":" << group.size()
+                      << ",\"single_ms\":" << std::fixed << std::setprecision(2) << single_ms
+                      << ",\"batch_ms\":" << batch_ms
+                      << ",\"det_runs\":" << det_runs
+                      << ",\"mismatched_images\":" << mismatched << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed += static_cast<int>(group.size());
+            std::cerr << "  [ERROR] Batch predict failed for group starting at " << group.front() << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
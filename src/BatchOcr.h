@@ -0,0 +1,70 @@
+#pragma once
+
+#include "DocPreprocessor.h"
+#include "OcrResultJson.h"
+#include "TextDetector.h"
+#include "TextRecognizer.h"
+#include "TextlineClassifier.h"
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+struct BatchOcrTiming {
+    double orientation_ms = 0.0; // doc_ori
+    double det_ms = 0.0;
+    double crop_ms = 0.0;
+    double textline_ms = 0.0;    // textline_ori
+    double rec_ms = 0.0;
+    int det_runs = 0;            // detection predictor runs (one per input shape bucket)
+};
+
+// Multi-image OCR on the native stage layer. Each stage runs once per call
+// over every image instead of once per image: doc_ori classifies all pages in
+// one batch, det batches pages that resize to the same input shape, and
+// textline_ori / rec see the crops of all pages together, so rec buckets fill
+// up across page boundaries. doc_ori and textline_ori are optional (nullptr).
+class BatchOcr {
+public:
+    BatchOcr(TextDetector& detector, TextRecognizer& recognizer, TextlineClassifier* textline,
+             DocPreprocessor* doc_orientation, const DetectorConfig& config = DetectorConfig());
+
+    // results[i] belongs to images[i]; polygons are in the coordinates of the upright page
+    std::vector<std::vector<OcrLine> > Predict(const std::vector<cv::Mat>& images);
+
+    // Decodes the files, then as above. Throws std::runtime_error for unreadable files.
+    std::vector<std::vector<OcrLine> > Predict(const std::vector<std::string>& image_paths);
+
+    // Stage times of the last Predict call
+    const BatchOcrTiming& LastTiming() const { return timing_; }
+
+    // Switches the tensors of every stage used here between shared pooled buffers and copies
+    void SetZeroCopy(bool enabled);
+
+private:
+    TextDetector& detector_;
+    TextRecognizer& recognizer_;
+    TextlineClassifier* textline_;
+    DocPreprocessor* doc_orientation_;
+    DetectorConfig config_;
+    BatchOcrTiming timing_;
+};
+
+struct BatchPredictSummary {
+    int images = 0;
+    int failed = 0;
+    int mismatched_images = 0; // batched and single-image results read differently
+    double single_ms = 0.0;    // one Predict call per image, averaged over runs
+    double batch_ms = 0.0;     // one Predict call per group of batch_images
+    BatchOcrTiming single;     // stage sums, averaged over runs
+    BatchOcrTiming batched;
+};
+
+// Decodes all images up front, then times Predict over one image at a time
+// and over groups of `batch_images`, `runs` times each. Prints a
+// BATCH_PREDICT_RESULT line per group; batched results are saved as
+// <output_dir><stem>_res.json.
+BatchPredictSummary runBatchPredictBenchmark(const std::vector<std::string>& images,
+                                             BatchOcr& ocr,
+                                             int batch_images,
+                                             int runs,
+                                             const std::string& output_dir);
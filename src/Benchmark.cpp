@@ -1,15 +1,43 @@
 #include "src/api/pipelines/ocr.h"
+#include "BenchmarkOptions.h"
+#include "AsyncOcr.h"
+#include "BatchOcr.h"
+#include "BenchmarkUtils.h"
+#include "BlankPageCheck.h"
+#include "BoxMerge.h"
+#include "CascadeOcr.h"
+#include "CharsetRec.h"
+#include "CoarseToFineDet.h"
+#include "DocPreprocessor.h"
+#include "FusedTextlineRec.h"
+#include "ImageDecoder.h"
+#include "IncrementalOcr.h"
+#include "JsonSerializerBenchmark.h"
+#include "LineSplit.h"
+#include "OcrResultJson.h"
+#include "PageStream.h"
+#include "PageStreaming.h"
+#include "ReplayBenchmark.h"
+#include "ResultVisualizer.h"
+#include "StageCopyBenchmark.h"
+#include "StreamingOcr.h"
+#include "TemplateOcr.h"
+#include "VideoOcr.h"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
+#include <iterator>
 #include <dirent.h>
 #include <sys/stat.h>
 #include <cstdlib>
 #include <fstream>
 #include <sstream>
+#include <map>
+#include <stdexcept>
+#include <ctime>
 
 // Helper function to execute a command and capture its output
 bool ExecuteCommand(const std::string& command, std::string* result) {
@@ -43,7 +71,17 @@ bool isImageFile(const std::string& filepath) {
     
     std::string ext = filepath.substr(dot_pos);
     std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".tiff";
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".tif" || ext == ".tiff";
+}
+
+// Helper function to check if file is a video container handled by the frame-stream mode
+bool isVideoFile(const std::string& filepath) {
+    size_t dot_pos = filepath.find_last_of('.');
+    if (dot_pos == std::string::npos) return false;
+
+    std::string ext = filepath.substr(dot_pos);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".mp4" || ext == ".avi" || ext == ".mkv" || ext == ".mov" || ext == ".webm" || ext == ".m4v";
 }
 
 // Helper function to check if path is a directory
@@ -60,6 +98,17 @@ bool isFile(const std::string& path) {
     return S_ISREG(statbuf.st_mode);
 }
 
+// Helper function to get the milliseconds elapsed since `start`
+double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+}
+
+// Helper function to get the milliseconds between two steady_clock time points
+double elapsedMs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+}
+
 // Helper function to collect image files from directory recursively
 void collectImagesFromDirectory(const std::string& dirPath, std::vector<std::string>& imagePaths) {
     DIR* dir = opendir(dirPath.c_str());
@@ -82,18 +131,244 @@ void collectImagesFromDirectory(const std::string& dirPath, std::vector<std::str
     closedir(dir);
 }
 
+// Helper function to derive params for running the pipeline on crops: without
+// document orientation / unwarping, crop coordinates map straight back to the page
+PaddleOCRParams cropPipelineParams(const PaddleOCRParams& params) {
+    PaddleOCRParams crop_params = params;
+    crop_params.use_doc_orientation_classify = false;
+    crop_params.use_doc_unwarping = false;
+    return crop_params;
+}
+
+// Helper function to get the device string for models run outside the pipeline
+std::string stageDevice(const PaddleOCRParams& params) {
+    return params.device.has_value() ? params.device.value() : "cpu";
+}
+
+// Native stage models for the comparison modes, built from the pipeline configuration
+// on first use and shared by every mode that runs stages directly
+class StageModels {
+public:
+    explicit StageModels(const PaddleOCRParams& params) : params_(params) {}
+
+    TextDetector& Detector() {
+        if (!detector_) {
+            detector_.reset(new TextDetector(params_.text_detection_model_dir.value(), stageDevice(params_),
+                                             params_.cpu_threads));
+        }
+        return *detector_;
+    }
+
+    TextRecognizer& Recognizer() {
+        if (!recognizer_) {
+            recognizer_.reset(new TextRecognizer(params_.text_recognition_model_dir.value(), stageDevice(params_),
+                                                 params_.cpu_threads));
+        }
+        return *recognizer_;
+    }
+
+    TextlineClassifier& Classifier() {
+        if (!classifier_) {
+            classifier_.reset(new TextlineClassifier(params_.textline_orientation_model_dir.value(), stageDevice(params_),
+                                                     params_.cpu_threads));
+        }
+        return *classifier_;
+    }
+
+    DocPreprocessor& Preprocessor() {
+        if (!preprocessor_) {
+            preprocessor_.reset(new DocPreprocessor(params_.doc_orientation_classify_model_dir.value(),
+                                                    params_.doc_unwarping_model_dir.value(), stageDevice(params_),
+                                                    params_.cpu_threads));
+        }
+        return *preprocessor_;
+    }
+
+private:
+    PaddleOCRParams params_;
+    std::unique_ptr<TextDetector> detector_;
+    std::unique_ptr<TextRecognizer> recognizer_;
+    std::unique_ptr<TextlineClassifier> classifier_;
+    std::unique_ptr<DocPreprocessor> preprocessor_;
+};
+
+// Helper function to reproduce the page the pipeline ran detection on (doc orientation and
+// unwarping as configured in params), so polygons from its results line up when drawn
+cv::Mat pipelineInputPage(const std::string& image_path, const PaddleOCRParams& params, StageModels* stages) {
+    const bool orientation = params.doc_orientation_classify_model_dir.has_value() &&
+                             (!params.use_doc_orientation_classify.has_value() || params.use_doc_orientation_classify.value());
+    const bool unwarp = params.doc_unwarping_model_dir.has_value() &&
+                        (!params.use_doc_unwarping.has_value() || params.use_doc_unwarping.value());
+    if (!orientation && !unwarp) {
+        DecodedImage decoded;
+        decodeImage(image_path, 0, &decoded);
+        return decoded.image;
+    }
+    DocPreprocessTiming timing;
+    return stages->Preprocessor().Process(image_path, &timing, orientation, unwarp);
+}
+
+// Helper function to check if a command line argument is an option rather than a path
+bool isOptionArgument(const std::string& arg) {
+    return arg.size() > 2 && arg.compare(0, 2, "--") == 0;
+}
+
+// Helper function to parse "--name" / "--name=value" options
+BenchmarkOptions parseBenchmarkOptions(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (!isOptionArgument(arg)) continue;
+
+        std::string name = arg.substr(2);
+        std::string value;
+        size_t eq_pos = name.find('=');
+        if (eq_pos != std::string::npos) {
+            value = name.substr(eq_pos + 1);
+            name = name.substr(0, eq_pos);
+        }
+
+        if (name == "deferred_accuracy") {
+            options.deferred_accuracy = true;
+        } else if (name == "eval_workers") {
+            options.eval_workers = std::atoi(value.c_str());
+        } else if (name == "page_workers") {
+            options.page_workers = std::max(1, std::atoi(value.c_str()));
+        } else if (name == "blank_skip") {
+            options.blank_skip = true;
+            if (!value.empty()) options.blank_page.max_edge_density = std::atof(value.c_str());
+        } else if (name == "incremental") {
+            options.incremental = true;
+            if (!value.empty()) options.incremental_ocr.cache_dir = value + "/";
+        } else if (name == "tile_size") {
+            options.incremental_ocr.tile_size = std::atoi(value.c_str());
+        } else if (name == "replay") {
+            options.replay = true;
+            options.replay_options.trace_path = value;
+        } else if (name == "replay_seconds") {
+            options.replay_options.duration_s = std::atof(value.c_str());
+        } else if (name == "replay_rps") {
+            options.replay_options.interactive_rps = std::atof(value.c_str());
+        } else if (name == "replay_deadline_ms") {
+            options.replay_options.deadline_ms = std::atof(value.c_str());
+        } else if (name == "replay_bulk_jobs") {
+            options.replay_options.bulk_jobs = std::atoi(value.c_str());
+        } else if (name == "replay_workers") {
+            options.replay_options.workers = std::max(1, std::atoi(value.c_str()));
+        } else if (name == "replay_fifo") {
+            options.replay_options.strict_priority = false;
+        } else if (name == "no_admission") {
+            options.replay_options.admission.enabled = false;
+        } else if (name == "async") {
+            options.async_depths = {1, 2, 4, 8, 16, 32, 64};
+            if (!value.empty()) {
+                options.async_depths.clear();
+                std::stringstream depths(value);
+                std::string depth;
+                while (std::getline(depths, depth, ',')) {
+                    options.async_depths.push_back(std::max(1, std::atoi(depth.c_str())));
+                }
+            }
+        } else if (name == "async_workers") {
+            options.async_workers = std::max(1, std::atoi(value.c_str()));
+        } else if (name == "overload") {
+            options.overload = true;
+            if (!value.empty()) {
+                options.overload_loads.clear();
+                std::stringstream levels(value);
+                std::string level;
+                while (std::getline(levels, level, ',')) {
+                    options.overload_loads.push_back(std::atof(level.c_str()));
+                }
+            }
+        } else if (name == "cascade") {
+            options.cascade = true;
+            if (!value.empty()) options.cascade_options.rec_threshold = std::atof(value.c_str());
+        } else if (name == "cascade_det") {
+            options.cascade = true;
+            options.cascade_options.det_cascade = true;
+        } else if (name == "coarse_to_fine") {
+            options.coarse_to_fine = true;
+        } else if (name == "coarse_side") {
+            options.coarse_to_fine_options.coarse_side = std::max(64, std::atoi(value.c_str()));
+        } else if (name == "json_bench") {
+            options.json_bench = true;
+        } else if (name == "decode_bench") {
+            options.decode_bench_side = value.empty() ? 960 : std::max(0, std::atoi(value.c_str()));
+        } else if (name == "batch_predict") {
+            options.batch_predict = value.empty() ? 8 : std::max(1, std::atoi(value.c_str()));
+        } else if (name == "zero_copy") {
+            options.zero_copy = true;
+        } else if (name == "streaming") {
+            options.streaming = true;
+        } else if (name == "box_merge") {
+            options.box_merge = true;
+        } else if (name == "merge_gap") {
+            options.box_merge = true;
+            options.box_merge_options.max_gap = std::atof(value.c_str());
+        } else if (name == "line_split") {
+            options.line_split = true;
+            if (!value.empty()) options.line_split_options.max_width = std::max(64, std::atoi(value.c_str()));
+        } else if (name == "split_overlap") {
+            options.line_split = true;
+            options.line_split_options.overlap = std::max(0.0, std::atof(value.c_str()));
+        } else if (name == "fused_textline") {
+            options.fused_textline = true;
+        } else if (name == "skip_upright_ori") {
+            options.fused_textline = true;
+            options.fused_textline_options.skip_upright = true;
+        } else if (name == "doc_thumbnail") {
+            options.doc_thumbnail = true;
+        } else if (name == "vis") {
+            if (value == "full" || value == "fast" || value == "off") {
+                options.visualization.mode = value;
+            } else {
+                std::cerr << "Warning: Unknown --vis mode '" << value << "', using full" << std::endl;
+            }
+        } else if (name == "vis_every") {
+            options.visualization.every = std::max(1, std::atoi(value.c_str()));
+        } else if (name == "vis_scale") {
+            options.visualization.scale = std::atof(value.c_str());
+        } else if (name == "vis_format") {
+            options.visualization.format = value;
+        } else if (name == "vis_font") {
+            options.visualization.font_path = value;
+        } else if (name == "template") {
+            options.template_path = value;
+        } else if (name == "charset_fields") {
+            options.charset_fields = true;
+            if (!value.empty()) {
+                options.charset_specs.clear();
+                std::stringstream specs(value);
+                std::string spec;
+                while (std::getline(specs, spec, ',')) {
+                    if (!spec.empty()) options.charset_specs.push_back(spec);
+                }
+            }
+        } else if (name == "frame_diff_threshold") {
+            options.video.frame_diff_threshold = std::atof(value.c_str());
+        } else if (name == "video_full_ratio") {
+            options.video.full_frame_ratio = std::atof(value.c_str());
+        } else {
+            std::cerr << "Warning: Ignoring unknown option: " << arg << std::endl;
+        }
+    }
+    return options;
+}
+
 // Helper function to collect image files from directory or file list
 std::vector<std::string> collectImagePaths(int argc, char* argv[]) {
     std::vector<std::string> imagePaths;
     
     for (int i = 1; i < argc; i++) {
         std::string path = argv[i];
+        if (isOptionArgument(path)) continue;
         
         if (isDirectory(path)) {
             // If it's a directory, collect all image files
             collectImagesFromDirectory(path, imagePaths);
-        } else if (isFile(path) && isImageFile(path)) {
-            // If it's a single image file
+        } else if ((isFile(path) && (isImageFile(path) || isVideoFile(path))) || isImageSequencePattern(path)) {
+            // If it's a single image or video file, or an image sequence pattern
             imagePaths.push_back(path);
         } else {
             std::cerr << "Warning: Skipping invalid path: " << path << std::endl;
@@ -160,17 +435,215 @@ std::string calculateImageAccuracy(const std::string& image_name, const std::str
     return "{\"error\": \"No accuracy data found\"}";
 }
 
+// Helper function to read a numeric field from a flat JSON object (simple parsing)
+bool extractJsonNumber(const std::string& json, const std::string& key, double* value) {
+    size_t key_pos = json.find("\"" + key + "\":");
+    if (key_pos == std::string::npos) return false;
+    size_t value_start = json.find(":", key_pos) + 1;
+    size_t value_end = json.find_first_of(",}", value_start);
+    if (value_end == std::string::npos) return false;
+    std::string number = json.substr(value_start, value_end - value_start);
+    number.erase(std::remove_if(number.begin(), number.end(), ::isspace), number.end());
+    *value = std::atof(number.c_str());
+    return true;
+}
+
+// Performance numbers of one image, kept until accuracy is known in deferred mode
+struct PerImagePerformance {
+    std::string filename;
+    double inference_ms;
+    double fps;
+    double chars_per_second;
+    int total_chars;
+};
+
+// Helper function to print the structured per-image result for final table generation
+void printPerImageResult(const PerImagePerformance& perf, double accuracy) {
+    std::cout << "PER_IMAGE_RESULT:{\"filename\":\"" << perf.filename 
+              << "\",\"inference_ms\":" << std::fixed << std::setprecision(2) << perf.inference_ms 
+              << ",\"fps\":" << std::fixed << std::setprecision(2) << perf.fps 
+              << ",\"chars_per_second\":" << std::fixed << std::setprecision(2) << perf.chars_per_second 
+              << ",\"total_chars\":" << perf.total_chars 
+              << ",\"accuracy\":" << std::fixed << std::setprecision(4) << accuracy << "}" << std::endl;
+}
+
+// Helper function to write <stem>_perf.json next to <stem>_res.json so offline analysis
+// (calculate_acc.py --analysis) can relate errors to the time spent on the image
+void savePerformanceSidecar(const std::string& output_dir, const PerImagePerformance& perf) {
+    std::string stem = perf.filename;
+    size_t dot_pos = stem.find_last_of('.');
+    if (dot_pos != std::string::npos) {
+        stem = stem.substr(0, dot_pos);
+    }
+    std::ofstream out(output_dir + stem + "_perf.json");
+    if (!out) {
+        std::cerr << "  [WARNING] Could not write performance sidecar for " << perf.filename << std::endl;
+        return;
+    }
+    out << "{\"filename\": \"" << perf.filename << "\""
+        << ", \"inference_ms\": " << std::fixed << std::setprecision(3) << perf.inference_ms
+        << ", \"fps\": " << std::fixed << std::setprecision(3) << perf.fps
+        << ", \"chars_per_second\": " << std::fixed << std::setprecision(3) << perf.chars_per_second
+        << ", \"total_chars\": " << perf.total_chars << "}" << std::endl;
+}
+
+// Run calculate_acc.py once over the whole output directory (parallel across cores)
+// and collect per-image character accuracy keyed by image file name
+bool runDeferredAccuracy(const std::string& rootPath, const std::string& output_dir, int workers,
+                         const std::vector<std::string>& images, std::map<std::string, double>* accuracies,
+                         bool forward_summary = true) {
+    if (images.empty()) return true;
+    // Manifest of the images to score, so nothing else in output_dir is picked up
+    const std::string manifest_path = output_dir + "/scored_images.txt";
+    std::ofstream manifest(manifest_path);
+    for (const auto& image : images) manifest << image << "\n";
+    manifest.close();
+    if (!manifest) {
+        std::cerr << "[ERROR] Cannot write " << manifest_path << std::endl;
+        return false;
+    }
+
+    std::string command = "python " + rootPath + "/scripts/calculate_acc.py";
+    command += " --ground_truth \"" + rootPath + "/images/labels.json\"";
+    command += " --output_dir \"" + output_dir + "\"";
+    command += " --images \"" + manifest_path + "\"";
+    command += " --all --workers " + std::to_string(workers);
+
+    std::string result_str;
+    if (!ExecuteCommand(command, &result_str)) {
+        std::cerr << "[ERROR] Failed to execute dataset accuracy evaluation" << std::endl;
+        std::cerr << "[ERROR] Python script output:\n" << result_str << std::endl;
+        return false;
+    }
+
+    std::istringstream iss(result_str);
+    std::string line;
+    const std::string image_prefix = "IMAGE_ACC: ";
+    const std::string dataset_prefix = "DATASET_ACC: ";
+    while (std::getline(iss, line)) {
+        if (line.compare(0, image_prefix.size(), image_prefix) == 0) {
+            std::string json_data = line.substr(image_prefix.size());
+            size_t name_pos = json_data.find("\"image_name\": \"");
+            if (name_pos == std::string::npos) continue;
+            size_t name_start = name_pos + std::string("\"image_name\": \"").size();
+            size_t name_end = json_data.find('"', name_start);
+            double acc = 0.0;
+            if (name_end != std::string::npos && extractJsonNumber(json_data, "character_accuracy", &acc)) {
+                (*accuracies)[json_data.substr(name_start, name_end - name_start)] = acc;
+            }
+        } else if (forward_summary && line.compare(0, dataset_prefix.size(), dataset_prefix) == 0) {
+            // Forward the aggregate line so shell scripts can pick it up from the log
+            std::cout << line << std::endl;
+        }
+    }
+    return true;
+}
+
+// Helper function to list the file names of this run's images that have a result in
+// output_dir written since `since`; stale *_res.json from earlier runs are left out
+std::vector<std::string> freshResultImages(const std::string& output_dir, const std::vector<std::string>& image_paths,
+                                           std::time_t since) {
+    std::vector<std::string> images;
+    for (const auto& image_path : image_paths) {
+        struct stat statbuf;
+        const std::string result_path = output_dir + "/" + documentStem(image_path) + "_res.json";
+        if (stat(result_path.c_str(), &statbuf) != 0 || statbuf.st_mtime < since) continue;
+        images.push_back(image_path.substr(image_path.find_last_of('/') + 1));
+    }
+    return images;
+}
+
+// Helper function to score two result directories of this run against labels.json on
+// the images both produced, and average the per-image character accuracy of each
+// (0 when nothing could be scored). Returns the number of images compared.
+int pairedCharacterAccuracy(const std::string& dir_a, const std::string& dir_b,
+                            const std::vector<std::string>& image_paths, std::time_t since, int workers,
+                            double* mean_a, double* mean_b) {
+    *mean_a = 0.0;
+    *mean_b = 0.0;
+    std::vector<std::string> fresh_a = freshResultImages(dir_a, image_paths, since);
+    std::vector<std::string> fresh_b = freshResultImages(dir_b, image_paths, since);
+    std::sort(fresh_a.begin(), fresh_a.end());
+    std::sort(fresh_b.begin(), fresh_b.end());
+    std::vector<std::string> both;
+    std::set_intersection(fresh_a.begin(), fresh_a.end(), fresh_b.begin(), fresh_b.end(), std::back_inserter(both));
+
+    std::map<std::string, double> acc_a, acc_b;
+    runDeferredAccuracy(get_root_path(), dir_a, workers, both, &acc_a, false);
+    runDeferredAccuracy(get_root_path(), dir_b, workers, both, &acc_b, false);
+    int compared = 0;
+    for (const auto& entry : acc_a) {
+        std::map<std::string, double>::const_iterator other = acc_b.find(entry.first);
+        if (other == acc_b.end()) continue;
+        *mean_a += entry.second;
+        *mean_b += other->second;
+        compared++;
+    }
+    if (compared > 0) {
+        *mean_a /= compared;
+        *mean_b /= compared;
+    }
+    return compared;
+}
+
 int main(int argc, char* argv[]){
+    const std::time_t run_start = std::time(nullptr); // results older than this belong to earlier runs
     // Check if image path is provided as command line argument
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <image_path_or_directory> [image_path2] [image_path3] ..." << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [options] <image_path_or_directory> [image_path2] [image_path3] ..." << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --deferred_accuracy   Score all images in one parallel pass after the timed loop" << std::endl;
+        std::cerr << "  --eval_workers=N      Worker processes for the deferred pass (default: all cores)" << std::endl;
+        std::cerr << "  --page_workers=N      PaddleOCR instances for multi-page TIFFs / image sequences (default: 1)" << std::endl;
+        std::cerr << "  --blank_skip[=DENSITY]  Skip the pipeline for pages below this edge density (default: 0.001)" << std::endl;
+        std::cerr << "  --frame_diff_threshold=F  Changed thumbnail pixel fraction below which a video frame is skipped (default: 0.002)" << std::endl;
+        std::cerr << "  --video_full_ratio=F  Changed area fraction above which a whole video frame is re-OCRed (default: 0.4)" << std::endl;
+        std::cerr << "  --cascade[=SCORE]     Also run mobile det/rec with server rec fallback below SCORE (default: 0.9)" << std::endl;
+        std::cerr << "  --cascade_det         Cascade det as well: rerun unsure pages on server det/rec" << std::endl;
+        std::cerr << "  --coarse_to_fine      Also compare full-page det with low-res det + full-res det on text regions" << std::endl;
+        std::cerr << "  --coarse_side=N       Longer side of the coarse det pass (default: 640)" << std::endl;
+        std::cerr << "  --json_bench          Also time the pipeline's SaveToJson against the streaming writer on the same lines" << std::endl;
+        std::cerr << "  --decode_bench[=SIDE] Also time image decoding per format, full and DCT-reduced to SIDE (default: 960)" << std::endl;
+        std::cerr << "  --batch_predict[=N]   Also compare multi-image Predict over N images with one image per call (default: 8)" << std::endl;
+        std::cerr << "  --zero_copy           Also compare copied stage tensors with pooled shared buffers (bytes copied per image; CPU only)" << std::endl;
+        std::cerr << "  --streaming           Also measure time to first line with per-line result callbacks" << std::endl;
+        std::cerr << "  --box_merge           Also compare one rec crop per box with collinear boxes joined into one crop" << std::endl;
+        std::cerr << "  --merge_gap=F         Largest gap between joined boxes, in box heights (default: 3)" << std::endl;
+        std::cerr << "  --line_split[=WIDTH]  Also compare whole-line rec with lines wider than WIDTH rec pixels split into chunks (default: 960)" << std::endl;
+        std::cerr << "  --split_overlap=F     Chunk overlap around each cut, in rec heights (default: 1)" << std::endl;
+        std::cerr << "  --fused_textline      Also compare separate textline_ori + rec passes with one shared crop pass" << std::endl;
+        std::cerr << "  --skip_upright_ori    With --fused_textline: no 180 degree check for wide, horizontal boxes" << std::endl;
+        std::cerr << "  --doc_thumbnail       Also run doc orientation / unwarping from a shared thumbnail and compare" << std::endl;
+        std::cerr << "  --vis=full|fast|off   Result images: pipeline SaveToImg, reduced-resolution renderer, or none (default: full)" << std::endl;
+        std::cerr << "  --vis_every=N, --vis_scale=F, --vis_format=jpg|png" << std::endl;
+        std::cerr << "                        Visualize every Nth image; fast renderer scale and format (default: 1, 0.5, jpg)" << std::endl;
+        std::cerr << "  --vis_font=FILE       TrueType font for --vis=fast text, needs -DUSE_FREETYPE=ON (default: vis_font_dir)" << std::endl;
+        std::cerr << "  --template=FILE       Also run fixed-ROI form OCR with this layout and compare with the full pipeline" << std::endl;
+        std::cerr << "  --charset_fields[=LIST]  Also recognize labelled digit/date/ASCII fields with charset-constrained decoding (default: digits,date,ascii)" << std::endl;
+        std::cerr << "  --incremental[=DIR]   Re-OCR only tiles changed since the cached version (default cache: ./output/cache)" << std::endl;
+        std::cerr << "  --tile_size=N         Tile side in pixels for --incremental (default: 64)" << std::endl;
+        std::cerr << "  --replay[=TRACE]      Replay a JSONL request trace (or a synthetic one) through the priority queue" << std::endl;
+        std::cerr << "  --replay_seconds=F, --replay_rps=F, --replay_deadline_ms=F, --replay_bulk_jobs=N" << std::endl;
+        std::cerr << "                        Synthetic trace shape (default: 20 s, 1 req/s, 1500 ms, 2 jobs)" << std::endl;
+        std::cerr << "  --replay_workers=N    PaddleOCR instances serving replayed requests (default: 1)" << std::endl;
+        std::cerr << "  --replay_fifo         Serve replayed requests in arrival order (no priorities)" << std::endl;
+        std::cerr << "  --async[=D1,D2..]     PredictAsync throughput / latency at these in-flight depths (default: 1,2,4,...,64)" << std::endl;
+        std::cerr << "  --async_workers=N     PaddleOCR instances behind PredictAsync (default: 1)" << std::endl;
+        std::cerr << "  --overload[=L1,L2..]  Goodput / p99 sweep over offered load, in multiples of capacity" << std::endl;
+        std::cerr << "  --no_admission        Disable admission control for --replay / --overload" << std::endl;
         std::cerr << "Examples:" << std::endl;
         std::cerr << "  " << argv[0] << " ./general_ocr_002.png" << std::endl;
         std::cerr << "  " << argv[0] << " ./images/" << std::endl;
         std::cerr << "  " << argv[0] << " img1.png img2.jpg img3.png" << std::endl;
+        std::cerr << "  " << argv[0] << " --deferred_accuracy ./images/" << std::endl;
+        std::cerr << "  " << argv[0] << " --page_workers=2 archive.tiff scans/page_%04d.png" << std::endl;
+        std::cerr << "  " << argv[0] << " --frame_diff_threshold=0.005 screen_recording.mp4" << std::endl;
+        std::cerr << "  " << argv[0] << " --replay --replay_workers=2 ./images/" << std::endl;
         return 1;
     }
 
+    BenchmarkOptions options = parseBenchmarkOptions(argc, argv);
+
     // Collect all image paths
     std::cout << "[INFO] Collecting image paths from " << (argc - 1) << " input arguments..." << std::endl;
     std::vector<std::string> imagePaths = collectImagePaths(argc, argv);
@@ -181,7 +654,28 @@ int main(int argc, char* argv[]){
         return 1;
     }
     
+    // Multi-page TIFFs and image sequences are streamed page by page, videos frame by frame
+    std::vector<std::string> documentPaths;
+    std::vector<std::string> videoPaths;
+    for (size_t i = 0; i < imagePaths.size();) {
+        if (isVideoFile(imagePaths[i])) {
+            videoPaths.push_back(imagePaths[i]);
+            imagePaths.erase(imagePaths.begin() + i);
+        } else if (isMultiPageDocument(imagePaths[i])) {
+            documentPaths.push_back(imagePaths[i]);
+            imagePaths.erase(imagePaths.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    
     std::cout << "[SUCCESS] Found " << imagePaths.size() << " images to process" << std::endl;
+    if (!documentPaths.empty()) {
+        std::cout << "[SUCCESS] Found " << documentPaths.size() << " multi-page documents to stream" << std::endl;
+    }
+    if (!videoPaths.empty()) {
+        std::cout << "[SUCCESS] Found " << videoPaths.size() << " videos to process frame by frame" << std::endl;
+    }
     
     // Print first few image paths for verification
     std::cout << "[INFO] Sample images to be processed:" << std::endl;
@@ -222,10 +716,62 @@ int main(int argc, char* argv[]){
     auto init_end = std::chrono::high_resolution_clock::now();
     auto init_duration = std::chrono::duration_cast<std::chrono::milliseconds>(init_end - init_start);
     std::cout << "[SUCCESS] PaddleOCR initialized successfully in " << init_duration.count() << " ms" << std::endl;
+    StageModels stages(params); // native stage models, loaded by the first mode that needs them
+
+    // Stream multi-page inputs page by page across workers
+    PageStreamingSummary page_summary;
+    if (!documentPaths.empty()) {
+        std::cout << "\n[PAGES] Streaming " << documentPaths.size() << " multi-page documents with "
+                  << options.page_workers << " worker(s)..." << std::endl;
+        page_summary = runPageStreaming(documentPaths, infer, params, options.page_workers, "./output/");
+        double pages_per_second = page_summary.wall_ms > 0 ? page_summary.pages * 1000.0 / page_summary.wall_ms : 0.0;
+        std::cout << "[PAGES] Completed " << page_summary.pages << " pages (" << page_summary.failed_pages
+                  << " failed, " << page_summary.failed_documents << " documents failed to decode) in " << std::fixed << std::setprecision(2) << page_summary.wall_ms << " ms" << std::endl;
+        std::cout << "[PAGES] Throughput: " << std::fixed << std::setprecision(2) << pages_per_second
+                  << " pages/s, peak decoded pages queued: " << page_summary.queue_high_water << std::endl;
+        std::cout << "TIMING_INFO:PAGES:" << page_summary.pages << std::endl;
+        std::cout << "TIMING_INFO:PAGES_PER_SECOND:" << std::fixed << std::setprecision(2) << pages_per_second << std::endl;
+    }
+
+    // Video frames: skip unchanged frames, re-OCR only changed regions
+    VideoOcrSummary video_summary;
+    if (!videoPaths.empty()) {
+        std::cout << "\n[VIDEO] Initializing PaddleOCR without document preprocessing for video frames..." << std::endl;
+        PaddleOCR video_infer(cropPipelineParams(params));
+
+        std::cout << "[VIDEO] Processing " << videoPaths.size() << " videos (skip below "
+                  << options.video.frame_diff_threshold << " changed, full frame above "
+                  << options.video.full_frame_ratio << " changed area)..." << std::endl;
+        video_summary = runVideoOcr(videoPaths, video_infer, options.video, "./output/");
+        double effective_fps = video_summary.wall_ms > 0 ? video_summary.frames * 1000.0 / video_summary.wall_ms : 0.0;
+        double skip_ratio = video_summary.frames > 0 ? static_cast<double>(video_summary.skipped_frames) / video_summary.frames : 0.0;
+        std::cout << "[VIDEO] Frames: " << video_summary.frames << " (full " << video_summary.full_frames
+                  << ", partial " << video_summary.partial_frames << ", skipped " << video_summary.skipped_frames
+                  << ", failed " << video_summary.failed_frames << ")" << std::endl;
+        std::cout << "[VIDEO] Wall time: " << std::fixed << std::setprecision(2) << video_summary.wall_ms
+                  << " ms (decode " << video_summary.decode_ms << " ms, inference " << video_summary.inference_ms << " ms)" << std::endl;
+        std::cout << "[VIDEO] Effective FPS: " << std::fixed << std::setprecision(2) << effective_fps
+                  << ", skip ratio: " << std::setprecision(3) << skip_ratio
+                  << ", OCRed area: " << std::setprecision(1) << (100.0 * video_summary.ocr_area_ratio) << "%"
+                  << ", reused lines: " << video_summary.reused_lines << std::endl;
+        std::cout << "TIMING_INFO:VIDEO_FRAMES:" << video_summary.frames << std::endl;
+        std::cout << "TIMING_INFO:VIDEO_EFFECTIVE_FPS:" << std::fixed << std::setprecision(2) << effective_fps << std::endl;
+        std::cout << "TIMING_INFO:VIDEO_SKIP_RATIO:" << std::fixed << std::setprecision(3) << skip_ratio << std::endl;
+    }
 
     // Process all images in batch
     std::cout << "\n[BATCH] Starting batch processing of " << imagePaths.size() << " images..." << std::endl;
     std::vector<double> inference_times;
+    std::vector<PerImagePerformance> deferred_results;
+    std::map<std::string, double> full_pipeline_ms; // per file name, for the template comparison
+    if (options.visualization.font_path.empty() && params.vis_font_dir.has_value()) {
+        options.visualization.font_path = params.vis_font_dir.value();
+    }
+    GlyphAtlas glyph_atlas(options.visualization.mode == "fast" ? options.visualization.font_path : ""); // --vis=fast glyph cache, shared across images
+    double vis_total_ms = 0.0;
+    int vis_images = 0;
+    std::map<std::string, bool> blank_pages;         // per file name: skipped by --blank_skip or not
+    double blank_check_ms = 0.0;
     int successful_count = 0;
     int failed_count = 0;
     auto total_start = std::chrono::high_resolution_clock::now();
@@ -239,10 +785,35 @@ int main(int argc, char* argv[]){
             std::vector<double> run_times;
             std::vector<std::unique_ptr<BaseCVResult>> final_outputs;
             int total_chars = 0;
+
+            // Blank pages: the pre-check time stands in for inference and the result is empty
+            const std::string image_name = image_path.substr(image_path.find_last_of('/') + 1);
+            bool skip_page = false;
+            if (options.blank_skip) {
+                BlankPageCheck blank_check;
+                if (checkBlankPage(image_path, options.blank_page, &blank_check)) {
+                    skip_page = blank_check.blank;
+                    blank_check_ms += blank_check.check_ms;
+                    blank_pages[image_name] = skip_page;
+                    std::cout << "  [BLANK] Edge density " << std::fixed << std::setprecision(5) << blank_check.edge_density
+                              << ", stddev " << std::setprecision(2) << blank_check.stddev
+                              << " (" << blank_check.check_ms << " ms)"
+                              << (skip_page ? ", skipping pipeline" : "") << std::endl;
+                    if (skip_page) {
+                        run_times.push_back(blank_check.check_ms);
+                        std::string stem = image_name.substr(0, image_name.find_last_of('.'));
+                        if (!saveOcrLines("./output/" + stem + "_res.json", image_path, std::vector<OcrLine>())) {
+                            throw std::runtime_error("Cannot write empty result for " + image_name);
+                        }
+                    }
+                }
+            }
+
+            if (!skip_page) {
+                std::cout << "  [INFERENCE] Running 3 iterations for average metrics..." << std::endl;
+            }
             
-            std::cout << "  [INFERENCE] Running 3 iterations for average metrics..." << std::endl;
-            
-            for (int run = 0; run < 3; run++) {
+            for (int run = 0; run < 3 && !skip_page; run++) {
                 std::cout << "    [RUN " << (run+1) << "/3] Starting inference..." << std::endl;
                 auto start_inference_time = std::chrono::high_resolution_clock::now();
                 auto outputs = infer.Predict(image_path);
@@ -321,20 +892,46 @@ int main(int argc, char* argv[]){
             std::cout << "  [METRICS] Total characters detected: " << total_chars << std::endl;
             std::cout << "  [OUTPUT] Processing " << final_outputs.size() << " output(s)..." << std::endl;
             
-            // Save outputs (from first run)
+            // Save outputs (from first run); visualization is timed on its own
+            const VisualizationOptions& vis = options.visualization;
+            const bool visualize = vis.mode != "off" && !final_outputs.empty() && i % vis.every == 0;
+            double vis_ms = 0.0;
             for (size_t j = 0; j < final_outputs.size(); j++) {
                 std::cout << "    [OUTPUT " << (j+1) << "] Printing results..." << std::endl;
                 final_outputs[j]->Print();
-                std::cout << "    [OUTPUT " << (j+1) << "] Saving to image..." << std::endl;
-                final_outputs[j]->SaveToImg("./output/");
+                if (visualize && vis.mode == "full") {
+                    std::cout << "    [OUTPUT " << (j+1) << "] Saving to image..." << std::endl;
+                    auto vis_start = std::chrono::high_resolution_clock::now();
+                    final_outputs[j]->SaveToImg("./output/");
+                    vis_ms += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - vis_start).count() / 1e6;
+                }
                 std::cout << "    [OUTPUT " << (j+1) << "] Saving to JSON..." << std::endl;
                 final_outputs[j]->SaveToJson("./output/");
             }
-            
-            // Calculate accuracy immediately after saving outputs
-            std::cout << "  [ACCURACY] Calculating accuracy metrics..." << std::endl;
-            std::string rootPath = get_root_path();
-            std::string ground_truth_path = rootPath + "/images/labels.json";
+            if (visualize && vis.mode == "fast") {
+                // Timed end to end, like SaveToImg: the results only live inside the pipeline, so the
+                // page it saw (after doc orientation / unwarping) is prepared again here, then drawn
+                const std::string stem = documentStem(image_path);
+                auto vis_start = std::chrono::high_resolution_clock::now();
+                std::vector<OcrLine> vis_lines;
+                cv::Mat vis_page;
+                try {
+                    if (loadOcrLines("./output/" + stem + "_res.json", &vis_lines)) {
+                        vis_page = pipelineInputPage(image_path, params, &stages);
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "  [WARNING] Could not prepare the page for visualization: " << e.what() << std::endl;
+                }
+                if (vis_page.empty() || !saveFastVisualization(vis_page, vis_lines, stem, vis, &glyph_atlas, "./output/")) {
+                    std::cerr << "  [WARNING] Fast visualization failed for " << image_path << std::endl;
+                }
+                vis_ms += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - vis_start).count() / 1e6;
+            }
+            if (visualize) {
+                vis_total_ms += vis_ms;
+                vis_images++;
+                std::cout << "  [VIS] " << vis.mode << " visualization: " << std::fixed << std::setprecision(2) << vis_ms << " ms" << std::endl;
+            }
             
             // Extract just the filename for the python script
             std::string filename = image_path;
@@ -342,6 +939,22 @@ int main(int argc, char* argv[]){
             if (std::string::npos != last_slash_pos) {
                 filename.erase(0, last_slash_pos + 1);
             }
+            PerImagePerformance perf = {filename, avg_inference_ms, avg_fps, chars_per_second, total_chars};
+            full_pipeline_ms[filename] = avg_inference_ms;
+            savePerformanceSidecar("./output/", perf);
+
+            if (options.deferred_accuracy) {
+                // Accuracy is computed for all images at once after the batch loop
+                deferred_results.push_back(perf);
+                successful_count++;
+                std::cout << "  [SUCCESS] Image " << (i+1) << " processed successfully." << std::endl;
+                continue;
+            }
+
+            // Calculate accuracy immediately after saving outputs
+            std::cout << "  [ACCURACY] Calculating accuracy metrics..." << std::endl;
+            std::string rootPath = get_root_path();
+            std::string ground_truth_path = rootPath + "/images/labels.json";
 
             // Use the current activated conda environment python instead of conda run
             std::string command = "python " + rootPath + "/scripts/calculate_acc.py";
@@ -354,12 +967,7 @@ int main(int argc, char* argv[]){
                 std::cerr << "[ERROR] Failed to execute accuracy calculation for " << filename << std::endl;
                 std::cerr << "[ERROR] Python script output:\n" << result_str << std::endl;
                  // Still try to output performance data even if accuracy fails
-                std::cout << "PER_IMAGE_RESULT:{\"filename\":\"" << filename 
-                          << "\",\"inference_ms\":" << std::fixed << std::setprecision(2) << avg_inference_ms 
-                          << ",\"fps\":" << std::fixed << std::setprecision(2) << avg_fps 
-                          << ",\"chars_per_second\":" << std::fixed << std::setprecision(2) << chars_per_second 
-                          << ",\"total_chars\":" << total_chars 
-                          << ",\"accuracy\":0.0}" << std::endl;
+                printPerImageResult(perf, 0.0);
                 continue;
             }
 
@@ -371,25 +979,10 @@ int main(int argc, char* argv[]){
                 
                 // Extract accuracy value from JSON string (simple parsing)
                 double acc = 0.0;
-                size_t acc_pos = json_output.find("\"character_accuracy\":");
-                if (acc_pos != std::string::npos) {
-                    size_t value_start = json_output.find(":", acc_pos) + 1;
-                    size_t value_end = json_output.find_first_of(",}", value_start);
-                    if (value_end != std::string::npos) {
-                        std::string acc_str = json_output.substr(value_start, value_end - value_start);
-                        // Remove whitespace
-                        acc_str.erase(std::remove_if(acc_str.begin(), acc_str.end(), ::isspace), acc_str.end());
-                        acc = std::stod(acc_str);
-                    }
-                }
+                extractJsonNumber(json_output, "character_accuracy", &acc);
 
                 // Output the structured per-image result for final table generation
-                std::cout << "PER_IMAGE_RESULT:{\"filename\":\"" << filename 
-                          << "\",\"inference_ms\":" << std::fixed << std::setprecision(2) << avg_inference_ms 
-                          << ",\"fps\":" << std::fixed << std::setprecision(2) << avg_fps 
-                          << ",\"chars_per_second\":" << std::fixed << std::setprecision(2) << chars_per_second 
-                          << ",\"total_chars\":" << total_chars 
-                          << ",\"accuracy\":" << std::fixed << std::setprecision(4) << acc << "}" << std::endl;
+                printPerImageResult(perf, acc);
 
             } else {
                 std::cerr << "[ERROR] Could not find 'SINGLE_ACC:' prefix in Python script output for " << filename << std::endl;
@@ -420,6 +1013,642 @@ int main(int argc, char* argv[]){
     std::cout << "\n[BATCH] Batch processing completed!" << std::endl;
     std::cout << "[BATCH] Total time: " << total_duration.count() << " ms" << std::endl;
 
+    // Blank page pre-check: how many pages skipped the pipeline, and how many of those had labelled text
+    if (options.blank_skip && !blank_pages.empty()) {
+        int skipped = 0;
+        int false_skips = 0;
+        int missed_blanks = 0;
+        int labelled = 0;
+        std::map<std::string, int> label_lines;
+        bool have_labels = loadLabelledLineCounts(get_root_path() + "/images/labels.json", &label_lines);
+        for (const auto& page : blank_pages) {
+            if (page.second) skipped++;
+            std::map<std::string, int>::const_iterator label = label_lines.find(page.first);
+            if (label == label_lines.end()) continue;
+            labelled++;
+            if (page.second && label->second > 0) false_skips++;
+            if (!page.second && label->second == 0) missed_blanks++;
+        }
+        double false_skip_rate = skipped > 0 ? static_cast<double>(false_skips) / skipped : 0.0;
+        std::cout << "\n[BLANK] Checked " << blank_pages.size() << " pages in " << std::fixed << std::setprecision(2)
+                  << blank_check_ms << " ms (" << (blank_check_ms / blank_pages.size()) << " ms/page), skipped "
+                  << skipped << std::endl;
+        if (have_labels) {
+            std::cout << "[BLANK] Against labels.json (" << labelled << " labelled pages): " << false_skips
+                      << " skipped pages had text (false-skip rate " << std::setprecision(3) << false_skip_rate
+                      << "), " << missed_blanks << " empty pages ran the pipeline" << std::endl;
+        } else {
+            std::cout << "[BLANK] labels.json not found; false-skip rate not computed" << std::endl;
+        }
+        std::cout << "TIMING_INFO:BLANK_SKIPPED:" << skipped << std::endl;
+        std::cout << "TIMING_INFO:BLANK_FALSE_SKIPS:" << false_skips << std::endl;
+        std::cout << "TIMING_INFO:BLANK_CHECK_MS:" << std::fixed << std::setprecision(3)
+                  << (blank_check_ms / blank_pages.size()) << std::endl;
+    }
+
+    // Deferred mode: one parallel evaluation pass over all saved results, outside the timed loop
+    long long eval_ms = -1;
+    if (options.deferred_accuracy && !deferred_results.empty()) {
+        std::cout << "\n[ACCURACY] Evaluating " << deferred_results.size() << " images in one parallel pass..." << std::endl;
+        auto eval_start = std::chrono::high_resolution_clock::now();
+        std::map<std::string, double> accuracies;
+        bool eval_ok = runDeferredAccuracy(get_root_path(), get_root_path() + "/output", options.eval_workers,
+                                           freshResultImages(get_root_path() + "/output", imagePaths, run_start), &accuracies);
+        auto eval_end = std::chrono::high_resolution_clock::now();
+        eval_ms = std::chrono::duration_cast<std::chrono::milliseconds>(eval_end - eval_start).count();
+        std::cout << "[ACCURACY] Evaluation pass completed in " << eval_ms << " ms" << std::endl;
+
+        for (const auto& perf : deferred_results) {
+            std::map<std::string, double>::const_iterator it = accuracies.find(perf.filename);
+            if (eval_ok && it == accuracies.end()) {
+                std::cerr << "[ERROR] No accuracy result for " << perf.filename << std::endl;
+            }
+            printPerImageResult(perf, it != accuracies.end() ? it->second : 0.0);
+        }
+    }
+
+    // Template mode: the same images again with fixed ROIs straight to rec
+    if (!options.template_path.empty()) {
+        FormTemplate layout;
+        std::string template_error;
+        if (!loadFormTemplate(options.template_path, &layout, &template_error)) {
+            std::cerr << "\n[ERROR] Cannot load template " << options.template_path << ": " << template_error << std::endl;
+            failed_count++;
+        } else {
+            try {
+                std::cout << "\n[TEMPLATE] Loaded " << layout.regions.size() << " regions from " << options.template_path << std::endl;
+                TextRecognizer& recognizer = stages.Recognizer();
+                // Native det for "detect" regions runs on their crops
+                TextDetector* detector = nullptr;
+                for (const auto& region : layout.regions) {
+                    if (!region.detect) continue;
+                    detector = &stages.Detector();
+                    break;
+                }
+
+                TemplateOcrSummary template_summary = runTemplateOcr(imagePaths, layout, recognizer, detector, 3,
+                                                                     full_pipeline_ms, "./output/template/");
+                double full_total_ms = 0.0;
+                for (const auto& entry : full_pipeline_ms) full_total_ms += entry.second;
+                double template_avg = template_summary.images > 0 ? template_summary.total_ms / template_summary.images : 0.0;
+                double full_avg = full_pipeline_ms.empty() ? 0.0 : full_total_ms / full_pipeline_ms.size();
+                std::cout << "[TEMPLATE] " << template_summary.images << " images (" << template_summary.failed << " failed), "
+                          << template_summary.regions_recognized << " regions to rec, "
+                          << template_summary.regions_detected << " with local det" << std::endl;
+                std::cout << "[TEMPLATE] Average time: " << std::fixed << std::setprecision(2) << template_avg
+                          << " ms vs full pipeline " << full_avg << " ms (speedup "
+                          << (template_avg > 0 ? full_avg / template_avg : 0.0) << "x)" << std::endl;
+                std::cout << "TIMING_INFO:TEMPLATE_AVG:" << std::fixed << std::setprecision(2) << template_avg << "ms" << std::endl;
+                std::cout << "TIMING_INFO:TEMPLATE_FPS:" << std::fixed << std::setprecision(2)
+                          << (template_avg > 0 ? 1000.0 / template_avg : 0.0) << std::endl;
+                failed_count += template_summary.failed;
+            } catch (const std::exception& e) {
+                std::cerr << "[ERROR] Template OCR failed: " << e.what() << std::endl;
+                failed_count++;
+            }
+        }
+    }
+
+    // Restricted fields: labelled lines that fit a narrow charset, CTC decoding constrained to that charset
+    if (options.charset_fields) {
+        try {
+            std::cout << "\n[CHARSET] Recognizing restricted fields, full dictionary vs decoding constrained to their charset..." << std::endl;
+            TextRecognizer& recognizer = stages.Recognizer();
+            CharsetRecSummary cs = runCharsetRecBenchmark(imagePaths, get_root_path() + "/images/labels.json",
+                                                          options.charset_specs, recognizer, 3, "./output/charset/");
+            double full_ms = 0.0, restricted_ms = 0.0;
+            for (const auto& entry : cs.charsets) {
+                const CharsetFieldStats& stats = entry.second;
+                std::cout << "[CHARSET] " << entry.first << ": " << stats.fields << " fields, " << stats.classes << "/"
+                          << cs.dictionary_classes << " classes decoded, accuracy "
+                          << std::fixed << std::setprecision(4) << stats.full_accuracy << " -> " << stats.restricted_accuracy
+                          << ", rec " << std::setprecision(2) << stats.full_ms << " -> " << stats.restricted_ms
+                          << " ms (decode " << stats.full_decode_ms << " -> " << stats.restricted_decode_ms << " ms)" << std::endl;
+                full_ms += stats.full_ms;
+                restricted_ms += stats.restricted_ms;
+            }
+            std::cout << "TIMING_INFO:CHARSET_REC_SPEEDUP:" << std::fixed << std::setprecision(2)
+                      << (restricted_ms > 0 ? full_ms / restricted_ms : 0.0) << std::endl;
+            failed_count += cs.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Charset-restricted rec failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Cascade mode: mobile models first, server rec only for unsure lines
+    if (options.cascade) {
+        try {
+            const CascadeOptions& cascade = options.cascade_options;
+            std::cout << "\n[CASCADE] Mobile " << (cascade.det_cascade ? "det/rec" : "rec")
+                      << " first, server rec for lines scoring below " << cascade.rec_threshold << std::endl;
+            // Fallback crops are cut from the decoded image, so no document preprocessing
+            PaddleOCRParams mobile_params = cropPipelineParams(params);
+            mobile_params.text_recognition_model_dir = "models/PP-OCRv5_mobile_rec_infer";
+            mobile_params.text_recognition_model_name = "PP-OCRv5_mobile_rec";
+            if (cascade.det_cascade) {
+                mobile_params.text_detection_model_dir = "models/PP-OCRv5_mobile_det_infer";
+                mobile_params.text_detection_model_name = "PP-OCRv5_mobile_det";
+            }
+            PaddleOCR mobile_infer(mobile_params);
+            // Pure-server baseline with the same settings, so the comparison is models only
+            PaddleOCR server_page(cropPipelineParams(params));
+            TextRecognizer& server_rec = stages.Recognizer();
+
+            CascadeSummary cs = runCascadeOcr(imagePaths, mobile_infer, server_page, server_rec, cascade, 3,
+                                              "./output/cascade/");
+            double server_avg = cs.images > 0 ? cs.server_ms / cs.images : 0.0;
+            double cascade_avg = cs.images > 0 ? cs.total_ms / cs.images : 0.0;
+            double fallback_rate = cs.lines > 0 ? static_cast<double>(cs.fallback_lines) / cs.lines : 0.0;
+
+            // Accuracy of both result sets against labels.json
+            double server_mean = 0.0, cascade_mean = 0.0;
+            pairedCharacterAccuracy(get_root_path() + "/output/cascade/server", get_root_path() + "/output/cascade/cascade", imagePaths,
+                                    run_start, options.eval_workers, &server_mean, &cascade_mean);
+
+            std::cout << "[CASCADE] " << cs.images << " images (" << cs.failed << " failed), " << cs.lines << " lines, "
+                      << cs.fallback_lines << " to server rec (" << std::fixed << std::setprecision(1) << (100.0 * fallback_rate)
+                      << "%), " << cs.improved_lines << " improved, " << cs.page_fallbacks << " page fallbacks" << std::endl;
+            std::cout << "[CASCADE] Average time: " << std::setprecision(2) << cascade_avg << " ms (first pass "
+                      << (cs.images > 0 ? cs.first_pass_ms / cs.images : 0.0) << " ms, fallback "
+                      << (cs.images > 0 ? cs.fallback_ms / cs.images : 0.0) << " ms) vs server " << server_avg << " ms" << std::endl;
+            std::cout << "[CASCADE] Character accuracy: " << std::setprecision(4) << cascade_mean
+                      << " vs server " << server_mean << std::endl;
+            std::cout << "CASCADE_SUMMARY:{\"fallback_rate\":" << std::setprecision(4) << fallback_rate
+                      << ",\"cascade_ms\":" << std::setprecision(2) << cascade_avg
+                      << ",\"server_ms\":" << server_avg
+                      << ",\"cascade_accuracy\":" << std::setprecision(4) << cascade_mean
+                      << ",\"server_accuracy\":" << server_mean
+                      << ",\"page_fallbacks\":" << cs.page_fallbacks << "}" << std::endl;
+            failed_count += cs.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Cascade OCR failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Coarse-to-fine det: low-resolution pass to find text, full resolution only around it
+    if (options.coarse_to_fine) {
+        try {
+            std::cout << "\n[C2F] Comparing full-page det with coarse-to-fine det (coarse side "
+                      << options.coarse_to_fine_options.coarse_side << "px)..." << std::endl;
+            TextDetector& detector = stages.Detector();
+            TextRecognizer& recognizer = stages.Recognizer();
+            CoarseToFineSummary c2f = runCoarseToFineBenchmark(imagePaths, detector, recognizer, DetectorConfig(),
+                                                               options.coarse_to_fine_options, 3, "./output/coarse_to_fine/");
+            double mean_recall = c2f.images > 0 ? c2f.recall_sum / c2f.images : 0.0;
+            double saved = c2f.refined_full_det_ms > 0 ? 1.0 - c2f.refined_c2f_det_ms / c2f.refined_full_det_ms : 0.0;
+            std::cout << "[C2F] " << c2f.images << " images (" << c2f.failed << " failed): " << c2f.refined
+                      << " refined on regions, " << c2f.fallbacks << " fell back to full-page det" << std::endl;
+            std::cout << "[C2F] Decode + det time: " << std::fixed << std::setprecision(2) << c2f.c2f_det_ms << " ms vs "
+                      << c2f.full_det_ms << " ms full-page; on refined pages " << c2f.refined_c2f_det_ms << " ms vs "
+                      << c2f.refined_full_det_ms << " ms (" << std::setprecision(1) << (100.0 * saved) << "% saved)" << std::endl;
+            std::cout << "[C2F] Mean box recall vs full-page det: " << std::setprecision(4) << mean_recall << std::endl;
+            std::cout << "TIMING_INFO:C2F_SAVED_ON_REFINED:" << std::setprecision(1) << (100.0 * saved) << "%" << std::endl;
+            std::cout << "TIMING_INFO:C2F_RECALL:" << std::setprecision(4) << mean_recall << std::endl;
+            failed_count += c2f.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Coarse-to-fine det failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Result JSON: the pipeline's SaveToJson vs the streaming formatter behind saveOcrLines
+    if (options.json_bench) {
+        std::cout << "\n[JSON] Writing " << imagePaths.size() << " results with SaveToJson and the streaming writer..." << std::endl;
+        JsonSerializerSummary js = runJsonSerializerBenchmark(imagePaths, infer, 20, "./output/json_bench/");
+        double save_mbps = js.save_to_json_ms > 0 ? js.save_to_json_bytes / 1e3 / js.save_to_json_ms : 0.0;
+        double stream_mbps = js.stream_ms > 0 ? js.stream_bytes / 1e3 / js.stream_ms : 0.0;
+        std::cout << "[JSON] " << js.documents << " documents (" << js.failed << " failed): SaveToJson " << std::fixed
+                  << std::setprecision(3) << js.save_to_json_ms << " ms (" << js.save_to_json_bytes << " bytes, "
+                  << std::setprecision(1) << save_mbps << " MB/s), streaming " << std::setprecision(3) << js.stream_ms
+                  << " ms (" << js.stream_bytes << " bytes, " << std::setprecision(1) << stream_mbps << " MB/s), "
+                  << js.mismatches << " documents with differing shared fields" << std::endl;
+        std::cout << "TIMING_INFO:JSON_SERIALIZE_SPEEDUP:" << std::setprecision(2)
+                  << (js.stream_ms > 0 ? js.save_to_json_ms / js.stream_ms : 0.0) << std::endl;
+        failed_count += js.failed + js.mismatches;
+    }
+
+    // Decode throughput per format: imread vs the decode layer, full and DCT-reduced
+    if (options.decode_bench_side >= 0) {
+        std::cout << "\n[DECODE] Timing " << imagePaths.size() << " images, reduced target side "
+                  << options.decode_bench_side << "..." << std::endl;
+        for (const auto& library : imageCodecLibraries()) std::cout << "[DECODE] " << library << std::endl;
+        DecodeSummary ds = runDecodeBenchmark(imagePaths, options.decode_bench_side, 3, params.cpu_threads);
+        size_t total_bytes = 0;
+        double full_ms = 0.0, reduced_ms = 0.0;
+        for (const auto& entry : ds.formats) {
+            total_bytes += entry.second.bytes;
+            full_ms += entry.second.full_ms;
+            reduced_ms += entry.second.reduced_ms;
+        }
+        double full_mbps = full_ms > 0 ? total_bytes / 1e3 / full_ms : 0.0;
+        double reduced_mbps = reduced_ms > 0 ? total_bytes / 1e3 / reduced_ms : 0.0;
+        double parallel_mbps = ds.parallel_wall_ms > 0 ? total_bytes / 1e3 / ds.parallel_wall_ms : 0.0;
+        std::cout << "[DECODE] " << std::fixed << std::setprecision(1) << full_mbps << " MB/s full, "
+                  << reduced_mbps << " MB/s reduced, " << parallel_mbps << " MB/s reduced on "
+                  << ds.workers << " threads, " << ds.failed << " failed" << std::endl;
+        std::cout << "TIMING_INFO:DECODE_MB_S:" << std::setprecision(2) << full_mbps << std::endl;
+        std::cout << "TIMING_INFO:DECODE_REDUCED_MB_S:" << reduced_mbps << std::endl;
+        failed_count += ds.failed;
+    }
+
+    // Batch Predict: every stage once per group of images instead of once per image
+    if (options.batch_predict > 0) {
+        try {
+            std::cout << "\n[BATCH_API] Comparing Predict over " << options.batch_predict
+                      << " images per call with one image per call..." << std::endl;
+            DocPreprocessor& doc_orientation = stages.Preprocessor();
+            TextDetector& detector = stages.Detector();
+            TextlineClassifier& classifier = stages.Classifier();
+            TextRecognizer& recognizer = stages.Recognizer();
+            BatchOcr batch_ocr(detector, recognizer, &classifier, &doc_orientation);
+            BatchPredictSummary bp = runBatchPredictBenchmark(imagePaths, batch_ocr, options.batch_predict, 3, "./output/batch/");
+            double single_ips = bp.single_ms > 0 ? bp.images * 1000.0 / bp.single_ms : 0.0;
+            double batch_ips = bp.batch_ms > 0 ? bp.images * 1000.0 / bp.batch_ms : 0.0;
+
+            double pipeline_mean = 0.0, batch_mean = 0.0;
+            int batch_scored = pairedCharacterAccuracy(get_root_path() + "/output", get_root_path() + "/output/batch",
+                                                       imagePaths, run_start, options.eval_workers, &pipeline_mean, &batch_mean);
+
+            std::cout << "[BATCH_API] " << bp.images << " images (" << bp.failed << " failed), det runs "
+                      << bp.single.det_runs << " -> " << bp.batched.det_runs << ", " << bp.mismatched_images
+                      << " images read differently when batched" << std::endl;
+            std::cout << "[BATCH_API] Throughput: " << std::fixed << std::setprecision(2) << single_ips << " -> "
+                      << batch_ips << " images/s (" << bp.single_ms << " -> " << bp.batch_ms << " ms)" << std::endl;
+            std::cout << "[BATCH_API] Stages, single -> batched: doc_ori " << bp.single.orientation_ms << " -> "
+                      << bp.batched.orientation_ms << " ms, det " << bp.single.det_ms << " -> " << bp.batched.det_ms
+                      << " ms, textline_ori " << bp.single.textline_ms << " -> " << bp.batched.textline_ms
+                      << " ms, rec " << bp.single.rec_ms << " -> " << bp.batched.rec_ms << " ms" << std::endl;
+            std::cout << "[BATCH_API] Character accuracy, pipeline -> batched: " << std::setprecision(4) << pipeline_mean
+                      << " -> " << batch_mean << " (" << batch_scored << " images)" << std::endl;
+            std::cout << "TIMING_INFO:BATCH_API_SPEEDUP:" << std::setprecision(2)
+                      << (single_ips > 0 ? batch_ips / single_ips : 0.0) << std::endl;
+            failed_count += bp.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Batch Predict benchmark failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Stage tensors: CopyFromCpu / CopyToCpu vs pooled buffers bound with ShareExternalData
+    if (options.zero_copy && stageDevice(params).compare(0, 3, "gpu") == 0) {
+        // GPU predictors copy through the pooled buffers either way, so both runs would be identical
+        std::cout << "\n[ZERO_COPY] Skipped: shared buffers only apply to CPU predictors, on "
+                  << stageDevice(params) << " the comparison is a no-op" << std::endl;
+    } else if (options.zero_copy) {
+        try {
+            std::cout << "\n[ZERO_COPY] Comparing copied stage tensors with shared pooled buffers..." << std::endl;
+            TextDetector& detector = stages.Detector();
+            TextlineClassifier& classifier = stages.Classifier();
+            TextRecognizer& recognizer = stages.Recognizer();
+            BatchOcr ocr(detector, recognizer, &classifier, nullptr);
+            StageCopySummary sc = runStageCopyBenchmark(imagePaths, ocr, 3);
+            double n = sc.images > 0 ? sc.images : 1;
+            std::cout << "[ZERO_COPY] " << sc.images << " images (" << sc.failed << " failed), "
+                      << sc.text_mismatches << " lines read differently" << std::endl;
+            std::cout << "[ZERO_COPY] Bytes copied per image: " << std::fixed << std::setprecision(0)
+                      << sc.copied_bytes_before / n << " -> " << sc.copied_bytes_after / n << " ("
+                      << sc.shared_bytes_after / n << " shared), Predict " << std::setprecision(2)
+                      << sc.copy_ms / n << " -> " << sc.zero_copy_ms / n << " ms" << std::endl;
+            std::cout << "TIMING_INFO:STAGE_BYTES_COPIED_BEFORE:" << std::setprecision(0) << sc.copied_bytes_before / n << std::endl;
+            std::cout << "TIMING_INFO:STAGE_BYTES_COPIED_AFTER:" << sc.copied_bytes_after / n << std::endl;
+            failed_count += sc.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Zero-copy benchmark failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Streaming results: lines handed out per rec batch, top of the page first
+    if (options.streaming) {
+        try {
+            std::cout << "\n[STREAM] Comparing whole-page results with per-line callbacks..." << std::endl;
+            TextDetector& detector = stages.Detector();
+            TextlineClassifier& classifier = stages.Classifier();
+            TextRecognizer& recognizer = stages.Recognizer();
+            BatchOcr full_page(detector, recognizer, &classifier, nullptr);
+            StreamingOcr streaming(detector, recognizer, &classifier);
+            StreamingSummary st = runStreamingBenchmark(imagePaths, full_page, streaming, 3, "./output/streaming/");
+            double n = st.images > 0 ? st.images : 1;
+            std::cout << "[STREAM] " << st.images << " images (" << st.failed << " failed), " << st.lines << " lines" << std::endl;
+            std::cout << "[STREAM] Average time to first line: " << std::fixed << std::setprecision(2) << st.first_line_ms / n
+                      << " ms, to last line: " << st.stream_total_ms / n << " ms, whole-page result: "
+                      << st.full_ms / n << " ms" << std::endl;
+            std::cout << "TIMING_INFO:TIME_TO_FIRST_LINE_MS:" << std::setprecision(2) << st.first_line_ms / n << std::endl;
+            failed_count += st.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Streaming benchmark failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Fused textline orientation: one crop per box shared by textline_ori and rec
+    if (options.fused_textline) {
+        try {
+            std::cout << "\n[TEXTLINE] Comparing separate textline_ori / rec passes with the fused crop pass"
+                      << (options.fused_textline_options.skip_upright ? " (upright boxes unchecked)" : "") << "..." << std::endl;
+            TextDetector& detector = stages.Detector();
+            TextlineClassifier& classifier = stages.Classifier();
+            TextRecognizer& recognizer = stages.Recognizer();
+            FusedTextlineSummary tl = runFusedTextlineBenchmark(imagePaths, detector, classifier, recognizer, DetectorConfig(),
+                                                                options.fused_textline_options, 3, "./output/textline/");
+            const TextlineRecTiming& sep = tl.separate;
+            const TextlineRecTiming& fus = tl.fused;
+            double sep_total = sep.crop_ms + sep.orientation_ms + sep.rec_ms;
+            double fus_total = fus.crop_ms + fus.orientation_ms + fus.rec_ms;
+
+            double sep_mean = 0.0, fus_mean = 0.0;
+            pairedCharacterAccuracy(get_root_path() + "/output/textline/separate", get_root_path() + "/output/textline/fused", imagePaths,
+                                    run_start, options.eval_workers, &sep_mean, &fus_mean);
+
+            std::cout << "[TEXTLINE] " << tl.images << " images (" << tl.failed << " failed), " << fus.crops << " crops, "
+                      << fus.checked << " checked by textline_ori (" << fus.flipped << " flipped), "
+                      << tl.text_mismatches << " lines read differently" << std::endl;
+            std::cout << "[TEXTLINE] All images, crop: " << std::fixed << std::setprecision(2) << sep.crop_ms << " -> " << fus.crop_ms
+                      << " ms, textline_ori: " << sep.orientation_ms << " -> " << fus.orientation_ms
+                      << " ms, rec: " << sep.rec_ms << " -> " << fus.rec_ms
+                      << " ms, total: " << sep_total << " -> " << fus_total << " ms" << std::endl;
+            std::cout << "[TEXTLINE] Character accuracy: " << std::setprecision(4) << fus_mean
+                      << " vs separate " << sep_mean << std::endl;
+            std::cout << "TIMING_INFO:TEXTLINE_SAVED_MS:" << std::setprecision(2) << (sep_total - fus_total) << std::endl;
+            failed_count += tl.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Fused textline benchmark failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Box merging: neighbouring boxes on one baseline recognized as one crop
+    if (options.box_merge) {
+        try {
+            std::cout << "\n[MERGE] Comparing one rec crop per box with collinear boxes joined..." << std::endl;
+            TextDetector& detector = stages.Detector();
+            TextRecognizer& recognizer = stages.Recognizer();
+            BoxMergeSummary bm = runBoxMergeBenchmark(imagePaths, detector, recognizer, DetectorConfig(),
+                                                      options.box_merge_options, 3, "./output/box_merge/");
+            const BoxMergeTiming& sep = bm.separate;
+            const BoxMergeTiming& mrg = bm.merged;
+
+            double sep_mean = 0.0, mrg_mean = 0.0;
+            pairedCharacterAccuracy(get_root_path() + "/output/box_merge/separate", get_root_path() + "/output/box_merge/merged", imagePaths,
+                                    run_start, options.eval_workers, &sep_mean, &mrg_mean);
+
+            std::cout << "[MERGE] " << bm.images << " images (" << bm.failed << " failed), rec crops " << sep.crops
+                      << " -> " << mrg.crops << ", " << bm.text_mismatches << " boxes read differently" << std::endl;
+            std::cout << "[MERGE] All images, crop: " << std::fixed << std::setprecision(2) << sep.crop_ms << " -> " << mrg.crop_ms
+                      << " ms, rec: " << sep.rec_ms << " -> " << mrg.rec_ms << " ms" << std::endl;
+            std::cout << "[MERGE] Character accuracy: " << std::setprecision(4) << mrg_mean
+                      << " vs separate " << sep_mean << std::endl;
+            std::cout << "TIMING_INFO:MERGE_CROPS_SAVED:" << (sep.crops - mrg.crops) << std::endl;
+            std::cout << "TIMING_INFO:MERGE_REC_SAVED_MS:" << std::setprecision(2) << (sep.rec_ms - mrg.rec_ms) << std::endl;
+            failed_count += bm.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Box merge benchmark failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Line splitting: over-long lines recognized as overlapping chunks alongside the other crops
+    if (options.line_split) {
+        try {
+            std::cout << "\n[SPLIT] Comparing whole-line rec with lines over " << options.line_split_options.max_width
+                      << " rec pixels split into chunks..." << std::endl;
+            TextDetector& detector = stages.Detector();
+            TextRecognizer& recognizer = stages.Recognizer();
+            LineSplitSummary ls = runLineSplitBenchmark(imagePaths, detector, recognizer, DetectorConfig(),
+                                                        options.line_split_options, 3, "./output/line_split/");
+
+            double whole_mean = 0.0, split_mean = 0.0;
+            pairedCharacterAccuracy(get_root_path() + "/output/line_split/whole", get_root_path() + "/output/line_split/split", imagePaths,
+                                    run_start, options.eval_workers, &whole_mean, &split_mean);
+
+            std::cout << "[SPLIT] " << ls.images << " images (" << ls.failed << " failed), " << ls.split.split_lines
+                      << " lines split on " << ls.long_line_pages << " pages, rec crops " << ls.whole.crops << " -> "
+                      << ls.split.crops << ", " << ls.text_mismatches << " lines read differently" << std::endl;
+            std::cout << "[SPLIT] All images, crop: " << std::fixed << std::setprecision(2) << ls.whole.crop_ms << " -> "
+                      << ls.split.crop_ms << " ms, rec: " << ls.whole.rec_ms << " -> " << ls.split.rec_ms << " ms" << std::endl;
+            if (!ls.split_ms.empty()) {
+                std::cout << "[SPLIT] Long-line pages, crop + rec p50 " << percentile(ls.whole_ms, 50) << " -> "
+                          << percentile(ls.split_ms, 50) << " ms, p95 " << percentile(ls.whole_ms, 95) << " -> "
+                          << percentile(ls.split_ms, 95) << " ms, max " << percentile(ls.whole_ms, 100) << " -> "
+                          << percentile(ls.split_ms, 100) << " ms" << std::endl;
+                std::cout << "TIMING_INFO:SPLIT_LONG_PAGE_P95:" << percentile(ls.split_ms, 95) << "ms" << std::endl;
+            }
+            std::cout << "[SPLIT] Character accuracy: " << std::setprecision(4) << split_mean
+                      << " vs whole lines " << whole_mean << std::endl;
+            failed_count += ls.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Line split benchmark failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Thumbnail document preprocessing: doc_ori / UVDoc inputs from one downscaled decode
+    if (options.doc_thumbnail) {
+        try {
+            std::cout << "\n[DOC] Running doc orientation / unwarping from shared thumbnails..." << std::endl;
+            DocPreprocessor& preprocessor = stages.Preprocessor();
+            std::cout << "[DOC] UVDoc export returns " << (preprocessor.UnwarpsFromThumbnail()
+                          ? "a backward map: unwarping runs on the thumbnail plus one full-resolution remap"
+                          : "the unwarped image: unwarping runs on the full page, as in the pipeline") << std::endl;
+            PaddleOCR page_infer(cropPipelineParams(params));
+            DocPreprocessSummary doc = runDocPreprocess(imagePaths, preprocessor, page_infer, 3, full_pipeline_ms,
+                                                        "./output/doc_preprocess/");
+            double pipeline_total_ms = 0.0;
+            for (const auto& entry : full_pipeline_ms) pipeline_total_ms += entry.second;
+            double pipeline_avg = full_pipeline_ms.empty() ? 0.0 : pipeline_total_ms / full_pipeline_ms.size();
+            double n = doc.images > 0 ? doc.images : 1;
+
+            double pipeline_mean = 0.0, doc_mean = 0.0;
+            int doc_scored = pairedCharacterAccuracy(get_root_path() + "/output", get_root_path() + "/output/doc_preprocess",
+                                                     imagePaths, run_start, options.eval_workers, &pipeline_mean, &doc_mean);
+
+            std::cout << "[DOC] " << doc.images << " images (" << doc.failed << " failed), " << doc.rotated
+                      << " rotated, " << doc.remapped << " unwarped with a full-resolution remap" << std::endl;
+            std::cout << "[DOC] Average per image: decode " << std::fixed << std::setprecision(2) << doc.decode_ms / n
+                      << " ms, orientation " << doc.orientation_ms / n << " ms, unwarp " << doc.unwarp_ms / n
+                      << " ms, OCR " << doc.ocr_ms / n << " ms; total " << doc.total_ms / n
+                      << " ms vs full pipeline " << pipeline_avg << " ms" << std::endl;
+            std::cout << "[DOC] Character accuracy, pipeline -> thumbnail preprocess: " << std::setprecision(4)
+                      << pipeline_mean << " -> " << doc_mean << " (" << doc_scored << " images)" << std::endl;
+            std::cout << "TIMING_INFO:DOC_PREPROCESS_MS:" << std::setprecision(2)
+                      << (doc.decode_ms + doc.orientation_ms + doc.unwarp_ms) / n << std::endl;
+            failed_count += doc.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Thumbnail document preprocessing failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Incremental mode: re-OCR only the tiles that changed since the cached version of each image
+    if (options.incremental) {
+        try {
+            std::cout << "\n[INCREMENTAL] Comparing " << imagePaths.size() << " images against the tile cache in "
+                      << options.incremental_ocr.cache_dir << " (" << options.incremental_ocr.tile_size << "px tiles)..." << std::endl;
+            PaddleOCR incremental_infer(cropPipelineParams(params));
+            IncrementalOcrSummary inc = runIncrementalOcr(imagePaths, incremental_infer, options.incremental_ocr,
+                                                          "./output/incremental/");
+            double work_saved = inc.page_pixels > 0 ? 1.0 - inc.ocr_pixels / inc.page_pixels : 0.0;
+            std::cout << "[INCREMENTAL] " << inc.images << " images: " << inc.cached << " unchanged, "
+                      << inc.partial << " partial, " << inc.full << " full, " << inc.failed << " failed" << std::endl;
+            std::cout << "[INCREMENTAL] Work saved: " << std::fixed << std::setprecision(1) << (100.0 * work_saved)
+                      << "% of page area not re-OCRed (hashing " << std::setprecision(2) << inc.hash_ms
+                      << " ms, inference " << inc.inference_ms << " ms)" << std::endl;
+            if (inc.cached_full_ms > 0) {
+                std::cout << "[INCREMENTAL] Pages with a cached full run: " << std::fixed << std::setprecision(2)
+                          << inc.incremental_ms << " ms now vs " << inc.cached_full_ms << " ms full ("
+                          << std::setprecision(1) << (100.0 * (1.0 - inc.incremental_ms / inc.cached_full_ms)) << "% time saved)" << std::endl;
+            }
+            std::cout << "TIMING_INFO:INCREMENTAL_WORK_SAVED:" << std::fixed << std::setprecision(1) << (100.0 * work_saved) << "%" << std::endl;
+            failed_count += inc.failed;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Incremental OCR failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // PredictAsync: requests kept in flight on the internal executor, completions in any order
+    if (!options.async_depths.empty()) {
+        std::vector<PaddleOCR*> engines(1, &infer);
+        std::vector<std::unique_ptr<PaddleOCR> > extra_engines;
+        try {
+            for (int w = 1; w < options.async_workers; w++) {
+                extra_engines.emplace_back(new PaddleOCR(params));
+                engines.push_back(extra_engines.back().get());
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Async worker failed to initialize, continuing with " << engines.size()
+                      << " worker(s): " << e.what() << std::endl;
+        }
+        try {
+            std::cout << "\n[ASYNC] Sweeping in-flight depth over PredictAsync with " << engines.size()
+                      << " worker(s)..." << std::endl;
+            int max_depth = *std::max_element(options.async_depths.begin(), options.async_depths.end());
+            std::vector<AsyncDepthPoint> points;
+            {
+                AsyncOcr async_ocr(engines, static_cast<size_t>(max_depth));
+                points = runAsyncDepthSweep(imagePaths, async_ocr, options.async_depths);
+            }
+            double best_throughput = 0.0;
+            int best_depth = 0;
+            for (const auto& point : points) {
+                std::cout << "[ASYNC] depth " << point.depth << ": " << std::fixed << std::setprecision(2)
+                          << point.throughput << " req/s, p50 " << point.p50_ms << " ms, p99 " << point.p99_ms
+                          << " ms, " << point.out_of_order << " out of order, " << point.failed << " failed" << std::endl;
+                if (point.throughput > best_throughput) {
+                    best_throughput = point.throughput;
+                    best_depth = point.depth;
+                }
+                failed_count += point.failed;
+            }
+            std::cout << "TIMING_INFO:ASYNC_PEAK_RPS:" << std::setprecision(2) << best_throughput
+                      << " (depth " << best_depth << ")" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] PredictAsync sweep failed: " << e.what() << std::endl;
+            failed_count++;
+        }
+    }
+
+    // Replay / overload modes: serve timed request traces through the admission-controlled priority queue
+    if (options.replay || options.overload) {
+        ReplayOptions replay = options.replay_options;
+        if (!inference_times.empty()) {
+            // Seed the admission cost estimate with the measured per-image time
+            double measured_ms = 0.0;
+            for (double time : inference_times) measured_ms += time;
+            replay.admission.initial_page_ms = measured_ms / inference_times.size();
+        }
+        replay.output_dir = "./output/replay/";
+        mkdir(replay.output_dir.c_str(), 0755);
+
+        std::vector<PaddleOCR*> engines(1, &infer);
+        std::vector<std::unique_ptr<PaddleOCR> > extra_engines;
+        try {
+            for (int w = 1; w < replay.workers; w++) {
+                extra_engines.emplace_back(new PaddleOCR(params));
+                engines.push_back(extra_engines.back().get());
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Replay worker failed to initialize, continuing with " << engines.size()
+                      << " worker(s): " << e.what() << std::endl;
+        }
+
+        if (options.replay) {
+            std::vector<ReplayEvent> events;
+            std::string trace_error;
+            if (replay.trace_path.empty()) {
+                events = synthesizeReplayTrace(imagePaths, replay);
+            } else if (!loadReplayTrace(replay.trace_path, &events, &trace_error)) {
+                std::cerr << "\n[ERROR] Cannot load replay trace: " << trace_error << std::endl;
+                failed_count++;
+            }
+            if (!events.empty()) {
+                const char* policy = replay.strict_priority ? "priority" : "fifo";
+                std::cout << "\n[REPLAY] Replaying " << events.size() << " requests ("
+                          << (replay.trace_path.empty() ? "synthetic trace" : replay.trace_path) << ") with "
+                          << engines.size() << " worker(s), " << policy << " scheduling..." << std::endl;
+                ReplaySummary replay_summary = runReplay(events, engines, replay);
+                std::cout << "[REPLAY] Completed in " << std::fixed << std::setprecision(2) << replay_summary.wall_ms
+                          << " ms, peak results waiting for output: " << replay_summary.output_queue_high_water << std::endl;
+                for (int c = 0; c < kRequestClassCount; c++) {
+                    const ReplayClassStats& stats = replay_summary.classes[c];
+                    if (stats.submitted == 0) continue;
+                    double miss_rate = stats.with_deadline > 0 ? static_cast<double>(stats.rejected + stats.expired + stats.late) / stats.with_deadline : 0.0;
+                    std::cout << "[REPLAY] " << requestClassName(static_cast<RequestClass>(c)) << ": "
+                              << stats.completed << "/" << stats.submitted << " completed, " << stats.rejected << " rejected, "
+                              << stats.deferrals << " deferrals, " << stats.expired << " expired, "
+                              << stats.late << " late, " << stats.failed << " failed, p50 " << std::setprecision(2) << percentile(stats.latencies_ms, 50)
+                              << " ms, p99 " << percentile(stats.latencies_ms, 99) << " ms, "
+                              << stats.preemptions << " preemptions" << std::endl;
+                    std::cout << "REPLAY_RESULT:{\"class\":\"" << requestClassName(static_cast<RequestClass>(c))
+                              << "\",\"policy\":\"" << policy
+                              << "\",\"submitted\":" << stats.submitted
+                              << ",\"completed\":" << stats.completed
+                              << ",\"rejected\":" << stats.rejected
+                              << ",\"deferrals\":" << stats.deferrals
+                              << ",\"expired\":" << stats.expired
+                              << ",\"late\":" << stats.late
+                              << ",\"failed\":" << stats.failed
+                              << ",\"deadline_miss_rate\":" << std::setprecision(4) << miss_rate
+                              << ",\"p50_ms\":" << std::setprecision(2) << percentile(stats.latencies_ms, 50)
+                              << ",\"p95_ms\":" << percentile(stats.latencies_ms, 95)
+                              << ",\"p99_ms\":" << percentile(stats.latencies_ms, 99)
+                              << ",\"preemptions\":" << stats.preemptions
+                              << ",\"pages\":" << stats.pages << "}" << std::endl;
+                    if (c == kInteractive) {
+                        std::cout << "TIMING_INFO:REPLAY_INTERACTIVE_P99:" << percentile(stats.latencies_ms, 99) << "ms" << std::endl;
+                        std::cout << "TIMING_INFO:REPLAY_DEADLINE_MISS_RATE:" << std::setprecision(4) << miss_rate << std::endl;
+                    }
+                }
+            }
+        }
+
+        if (options.overload) {
+            std::cout << "\n[OVERLOAD] Sweeping offered load with admission control "
+                      << (replay.admission.enabled ? "on" : "off") << " (" << engines.size() << " worker(s), "
+                      << std::fixed << std::setprecision(2) << replay.admission.initial_page_ms << " ms/page estimate, "
+                      << replay.duration_s << " s per level)..." << std::endl;
+            std::vector<OverloadPoint> points = runOverloadSweep(imagePaths, engines, replay, options.overload_loads);
+            for (const auto& point : points) {
+                std::cout << "[OVERLOAD] load " << std::setprecision(2) << point.load << "x (" << point.offered_rps
+                          << " req/s): goodput " << point.goodput_rps << " req/s, p99 " << point.p99_ms
+                          << " ms, rejected " << std::setprecision(1) << (100.0 * point.reject_rate) << "%" << std::endl;
+                std::cout << "OVERLOAD_RESULT:{\"load\":" << std::setprecision(2) << point.load
+                          << ",\"admission\":" << (replay.admission.enabled ? "true" : "false")
+                          << ",\"offered_rps\":" << point.offered_rps
+                          << ",\"goodput_rps\":" << point.goodput_rps
+                          << ",\"p99_ms\":" << point.p99_ms
+                          << ",\"submitted\":" << point.stats.submitted
+                          << ",\"completed\":" << point.stats.completed
+                          << ",\"rejected\":" << point.stats.rejected
+                          << ",\"expired\":" << point.stats.expired
+                          << ",\"late\":" << point.stats.late
+                          << ",\"failed\":" << point.stats.failed << "}" << std::endl;
+            }
+        }
+    }
+
     // Calculate statistics
     if (!inference_times.empty()) {
         std::cout << "\n[STATS] Calculating performance statistics..." << std::endl;
@@ -464,6 +1693,12 @@ int main(int argc, char* argv[]){
                   << avg_fps << std::endl;
         std::cout << "Batch throughput FPS: " << std::fixed << std::setprecision(2) 
                   << total_fps << std::endl;
+        if (vis_images > 0) {
+            std::cout << std::string(60, '-') << std::endl;
+            std::cout << "Visualization (" << options.visualization.mode << ", " << vis_images << " images): "
+                      << std::fixed << std::setprecision(2) << vis_total_ms << " ms total, "
+                      << (vis_total_ms / vis_images) << " ms/image" << std::endl;
+        }
         std::cout << std::string(60, '=') << std::endl;
         
         // Output timing info for shell script compatibility
@@ -474,9 +1709,15 @@ int main(int argc, char* argv[]){
         std::cout << "TIMING_INFO:AVG_FPS:" << std::fixed << std::setprecision(2) << avg_fps << std::endl;
         std::cout << "TIMING_INFO:BATCH_FPS:" << std::fixed << std::setprecision(2) << total_fps << std::endl;
         std::cout << "TIMING_INFO:SUCCESS_RATE:" << (100.0 * successful_count / imagePaths.size()) << "%" << std::endl;
-    } else {
+        if (vis_images > 0) {
+            std::cout << "TIMING_INFO:VIS:" << std::fixed << std::setprecision(2) << vis_total_ms << "ms" << std::endl;
+        }
+        if (eval_ms >= 0) {
+            std::cout << "TIMING_INFO:EVAL:" << eval_ms << "ms" << std::endl;
+        }
+    } else if (documentPaths.empty() && videoPaths.empty()) {
         std::cerr << "\n[ERROR] No successful inferences completed - cannot calculate statistics!" << std::endl;
     }
 
-    return (failed_count > 0) ? 1 : 0;
+    return (failed_count > 0 || page_summary.failed_pages > 0 || page_summary.failed_documents > 0 || video_summary.failed_frames > 0) ? 1 : 0;
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "BatchOcr.h"
+#include "BlankPageCheck.h"
+#include "BoxMerge.h"
+#include "CascadeOcr.h"
+#include "CoarseToFineDet.h"
+#include "FusedTextlineRec.h"
+#include "IncrementalOcr.h"
+#include "LineSplit.h"
+#include "ReplayBenchmark.h"
+#include "ResultVisualizer.h"
+#include "StreamingOcr.h"
+#include "VideoOcr.h"
+#include <string>
+#include <vector>
+
+// Command line options (arguments starting with "--"); everything else is an input path
+struct BenchmarkOptions {
+    bool deferred_accuracy = false; // --deferred_accuracy: score all images in one parallel pass after the timed loop
+    int eval_workers = 0;           // --eval_workers=N: processes for the deferred pass (0 = all cores)
+    int page_workers = 1;           // --page_workers=N: PaddleOCR instances sharing the pages of multi-page inputs
+    bool blank_skip = false;        // --blank_skip[=DENSITY]: return an empty result for blank pages without running the pipeline
+    BlankPageOptions blank_page;
+    bool incremental = false;       // --incremental[=DIR]: diff each image against its cached previous version by tile hashes
+    IncrementalOcrOptions incremental_ocr; // --tile_size=N: tile side for --incremental
+    std::vector<int> async_depths;  // --async[=D1,D2,...]: PredictAsync sweep over in-flight depths (default 1..64)
+    int async_workers = 1;          // --async_workers=N: PaddleOCR instances behind PredictAsync
+    bool replay = false;            // --replay[=TRACE]: serve a timed request trace through the priority queue
+    ReplayOptions replay_options;   // --replay_seconds, --replay_rps, --replay_deadline_ms, --replay_bulk_jobs, --replay_workers, --replay_fifo, --no_admission
+    bool overload = false;          // --overload[=L1,L2,...]: goodput / p99 sweep over offered load (x estimated capacity)
+    std::vector<double> overload_loads = {0.5, 1.0, 1.5, 2.0, 4.0};
+    bool cascade = false;           // --cascade[=SCORE], --cascade_det: mobile-first OCR with server fallback
+    CascadeOptions cascade_options;
+    bool coarse_to_fine = false;    // --coarse_to_fine, --coarse_side=N: two-pass det benchmark
+    CoarseToFineOptions coarse_to_fine_options;
+    bool json_bench = false;        // --json_bench: pipeline SaveToJson vs saveOcrLines on the same lines, shared fields byte-compared
+    int decode_bench_side = -1;     // --decode_bench[=SIDE]: decode MB/s per format, full and DCT-reduced towards SIDE
+    int batch_predict = 0;          // --batch_predict[=N]: multi-image Predict over groups of N images vs one at a time
+    bool zero_copy = false;         // --zero_copy: copied stage tensors vs pooled shared buffers, bytes copied per image
+    bool streaming = false;         // --streaming: per-line callbacks, time to first line vs whole-page results
+    bool box_merge = false;         // --box_merge, --merge_gap=F: collinear det boxes joined into one rec crop
+    BoxMergeOptions box_merge_options;
+    bool line_split = false;        // --line_split[=WIDTH], --split_overlap=F: over-long lines recognized as overlapping chunks
+    LineSplitOptions line_split_options;
+    bool fused_textline = false;    // --fused_textline, --skip_upright_ori: textline_ori folded into the rec buckets
+    FusedTextlineOptions fused_textline_options;
+    bool doc_thumbnail = false;     // --doc_thumbnail: doc orientation / unwarping from a shared thumbnail, then OCR
+    std::string template_path;      // --template=FILE: also run fixed-ROI form OCR and compare with the full pipeline
+    bool charset_fields = false;    // --charset_fields[=LIST]: labelled fields recognized with a restricted charset
+    std::vector<std::string> charset_specs = {"digits", "date", "ascii"};
+    VisualizationOptions visualization; // --vis=full|fast|off, --vis_every=N, --vis_scale=F, --vis_format=jpg|png
+    VideoOcrOptions video;          // --frame_diff_threshold=F, --video_full_ratio=F: frame skipping for video inputs
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// Shared helpers defined in Benchmark.cpp
+
+// Helper function to execute a command and capture its output
+bool ExecuteCommand(const std::string& command, std::string* result);
+
+// Helper function to get the root path of the project
+std::string get_root_path();
+
+// Helper function to check if file is an image
+bool isImageFile(const std::string& filepath);
+
+// Helper function to check if path is a directory
+bool isDirectory(const std::string& path);
+
+// Helper function to check if path is a regular file
+bool isFile(const std::string& path);
+
+// Helper function to get the milliseconds elapsed since `start`
+double elapsedMs(std::chrono::high_resolution_clock::time_point start);
+
+// Helper function to get the milliseconds between two steady_clock time points
+double elapsedMs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
@@ -0,0 +1,60 @@
+#include "BlankPageCheck.h"
+#include "ImageDecoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <opencv2/opencv.hpp>
+
+namespace {
+
+// Longer side the statistics are taken at; JPEGs decode near it in the DCT domain
+const int kThumbnailMaxSide = 512;
+
+// Thumbnails smaller than this are re-decoded at full size so that a short
+// line on a tiny crop still leaves edge pixels
+const int kMinThumbnailSide = 64;
+
+}  // namespace
+
+bool checkBlankPage(const std::string& image_path, const BlankPageOptions& options, BlankPageCheck* check) {
+    auto start = std::chrono::high_resolution_clock::now();
+    DecodedImage decoded;
+    if (!decodeImage(image_path, kThumbnailMaxSide, &decoded)) return false;
+    if (decoded.reduction > 1 && std::min(decoded.image.cols, decoded.image.rows) < kMinThumbnailSide &&
+        !decodeImage(image_path, 0, &decoded)) {
+        return false;
+    }
+    cv::Mat gray;
+    cv::cvtColor(decoded.image, gray, cv::COLOR_BGR2GRAY);
+
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(gray, mean, stddev);
+
+    cv::Mat edges;
+    cv::GaussianBlur(gray, gray, cv::Size(3, 3), 0);
+    cv::Canny(gray, edges, 50, 150);
+
+    check->stddev = stddev[0];
+    check->edge_density = static_cast<double>(cv::countNonZero(edges)) / edges.total();
+    check->blank = check->stddev < options.min_stddev || check->edge_density < options.max_edge_density;
+    auto end = std::chrono::high_resolution_clock::now();
+    check->check_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+    return true;
+}
+
+bool loadLabelledLineCounts(const std::string& labels_path, std::map<std::string, int>* counts) {
+    std::ifstream in(labels_path);
+    if (!in) return false;
+    nlohmann::json labels = nlohmann::json::parse(in, nullptr, false);
+    if (labels.is_discarded() || !labels.is_object()) return false;
+    for (auto it = labels.begin(); it != labels.end(); ++it) {
+        int lines = 0;
+        for (const auto& entry : it.value()) {
+            if (entry.contains("text") && !entry["text"].get<std::string>().empty()) lines++;
+        }
+        (*counts)[it.key()] = lines;
+    }
+    return true;
+}
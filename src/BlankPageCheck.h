@@ -0,0 +1,25 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+struct BlankPageOptions {
+    double max_edge_density = 0.001; // blank when fewer edge pixels than this share of the thumbnail
+    double min_stddev = 4.0;         // blank when the gray levels are flatter than this
+};
+
+struct BlankPageCheck {
+    bool blank = false;
+    double edge_density = 0.0;
+    double stddev = 0.0;
+    double check_ms = 0.0; // reduced decode + statistics
+};
+
+// Cheap pre-check run before the pipeline: decodes the image through
+// decodeImage with a 512px longer-side target (DCT-reduced for JPEGs),
+// converts it to gray and measures gray level spread and edge density. Pages
+// with neither are treated as blank and never reach det/rec.
+bool checkBlankPage(const std::string& image_path, const BlankPageOptions& options, BlankPageCheck* check);
+
+// Helper function to read how many text lines each image has in labels.json
+bool loadLabelledLineCounts(const std::string& labels_path, std::map<std::string, int>* counts);
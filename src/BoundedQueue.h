@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// Blocking FIFO with a fixed capacity. Producers wait while it is full, so the
+// amount of decoded data in flight never exceeds `capacity` items.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {}
+
+    // Blocks while full; returns false if the queue was closed
+    bool Push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+        if (items_.size() > high_water_) high_water_ = items_.size();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Blocks while empty; returns false once the queue is closed and drained
+    bool Pop(T* item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        *item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // No more pushes; consumers drain what is left and then stop
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    size_t Capacity() const { return capacity_; }
+
+    // Largest depth observed, to confirm memory stayed bounded
+    size_t HighWater() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return high_water_;
+    }
+
+private:
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<T> items_;
+    size_t high_water_ = 0;
+    bool closed_ = false;
+};
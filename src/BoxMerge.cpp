@@ -0,0 +1,304 @@
+#include "BoxMerge.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PageStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+// Geometry of a det quad (tl, tr, br, bl) as far as merging cares
+struct BoxShape {
+    bool usable = false;
+    float left = 0.0f;
+    float right = 0.0f;
+    float baseline = 0.0f;
+    float height = 0.0f;
+};
+
+BoxShape boxShape(const std::vector<cv::Point>& quad, double max_angle) {
+    BoxShape shape;
+    if (quad.size() != 4) return shape;
+    float width = std::max(pointDistance(quad[0], quad[1]), pointDistance(quad[3], quad[2]));
+    shape.height = 0.5f * (pointDistance(quad[0], quad[3]) + pointDistance(quad[1], quad[2]));
+    double angle = std::atan2(quad[1].y - quad[0].y, quad[1].x - quad[0].x) * 180.0 / CV_PI;
+    // Vertical text is cropped rotated; keep it out of horizontal runs
+    shape.usable = shape.height >= 1.0f && width >= 1.0f && shape.height < width * 1.5f && std::fabs(angle) <= max_angle;
+    shape.left = std::min(quad[0].x, quad[3].x);
+    shape.right = std::max(quad[1].x, quad[2].x);
+    shape.baseline = 0.5f * (quad[2].y + quad[3].y);
+    return shape;
+}
+
+bool continuesRun(const BoxShape& last, const BoxShape& next, const BoxMergeOptions& options) {
+    if (!last.usable || !next.usable) return false;
+    float shorter = std::min(last.height, next.height);
+    if (std::max(last.height, next.height) > shorter * options.max_height_ratio) return false;
+    if (std::fabs(last.baseline - next.baseline) > shorter * options.max_baseline_shift) return false;
+    float gap = next.left - last.right;
+    return gap >= -0.2f * shorter && gap <= shorter * options.max_gap;
+}
+
+void addTiming(const BoxMergeTiming& run, double scale, BoxMergeTiming* total) {
+    total->crop_ms += run.crop_ms * scale;
+    total->rec_ms += run.rec_ms * scale;
+}
+
+void recognizeSeparate(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextRecognizer& recognizer,
+                       std::vector<OcrLine>* lines, BoxMergeTiming* timing) {
+    *timing = BoxMergeTiming();
+    timing->boxes = timing->crops = static_cast<int>(boxes.size());
+    auto crop_start = std::chrono::high_resolution_clock::now();
+    std::vector<cv::Mat> crops;
+    for (const auto& box : boxes) crops.push_back(cropTextRegion(image, box.quad));
+    timing->crop_ms = elapsedMs(crop_start);
+
+    auto rec_start = std::chrono::high_resolution_clock::now();
+    std::vector<RecognizedText> texts;
+    recognizer.Recognize(crops, &texts);
+    timing->rec_ms = elapsedMs(rec_start);
+
+    lines->assign(boxes.size(), OcrLine());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        (*lines)[i].poly = boxes[i].quad;
+        (*lines)[i].text = texts[i].text;
+        (*lines)[i].score = texts[i].score;
+    }
+}
+
+// Helper function to drop the spaces rec puts into the gaps between joined boxes
+std::string trimSpaces(const std::string& text) {
+    size_t first = text.find_first_not_of(' ');
+    if (first == std::string::npos) return std::string();
+    return text.substr(first, text.find_last_not_of(' ') - first + 1);
+}
+
+}  // namespace
+
+void groupCollinearBoxes(const std::vector<DetectedBox>& boxes, const BoxMergeOptions& options,
+                         std::vector<std::vector<size_t> >* groups) {
+    groups->clear();
+    std::vector<BoxShape> shapes;
+    for (const auto& box : boxes) shapes.push_back(boxShape(box.quad, options.max_angle));
+
+    // Left to right, each box extends the run whose last box it continues most closely
+    std::vector<size_t> order(boxes.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return shapes[a].left < shapes[b].left; });
+    for (size_t index : order) {
+        int best = -1;
+        float best_gap = 0.0f;
+        for (size_t g = 0; g < groups->size(); g++) {
+            const BoxShape& last = shapes[(*groups)[g].back()];
+            if (!continuesRun(last, shapes[index], options)) continue;
+            float gap = std::fabs(shapes[index].left - last.right);
+            if (best < 0 || gap < best_gap) {
+                best = static_cast<int>(g);
+                best_gap = gap;
+            }
+        }
+        if (best >= 0) {
+            (*groups)[best].push_back(index);
+        } else {
+            groups->push_back(std::vector<size_t>(1, index));
+        }
+    }
+
+    // Back to reading order of the first box
+    std::sort(groups->begin(), groups->end(),
+              [](const std::vector<size_t>& a, const std::vector<size_t>& b) { return *std::min_element(a.begin(), a.end()) < *std::min_element(b.begin(), b.end()); });
+}
+
+void recognizeMerged(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextRecognizer& recognizer,
+                     const BoxMergeOptions& options, std::vector<OcrLine>* lines, BoxMergeTiming* timing) {
+    *timing = BoxMergeTiming();
+    timing->boxes = static_cast<int>(boxes.size());
+    const int height = recognizer.InputHeight();
+    const int max_width = recognizer.MaxInputWidth();
+    const int gap = std::max(1, height / 2); // a few CTC steps of background between boxes
+
+    auto crop_start = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<size_t> > groups;
+    groupCollinearBoxes(boxes, options, &groups);
+
+    std::vector<cv::Mat> crops;
+    std::vector<std::vector<size_t> > crop_boxes;
+    std::vector<std::vector<std::pair<int, int> > > crop_spans; // x range of each box in the joined crop
+    for (const auto& group : groups) {
+        if (group.size() == 1) {
+            crops.push_back(cropTextRegion(image, boxes[group[0]].quad));
+            crop_boxes.push_back(group);
+            crop_spans.push_back(std::vector<std::pair<int, int> >());
+            continue;
+        }
+        std::vector<cv::Mat> pieces;
+        for (size_t index : group) {
+            cv::Mat piece = cropTextRegion(image, boxes[index].quad);
+            if (piece.empty()) {
+                pieces.push_back(piece);
+                continue;
+            }
+            if (piece.channels() == 1) cv::cvtColor(piece, piece, cv::COLOR_GRAY2BGR);
+            int width = std::max(1, static_cast<int>(std::ceil(height * static_cast<double>(piece.cols) / piece.rows)));
+            cv::resize(piece, piece, cv::Size(width, height));
+            pieces.push_back(piece);
+        }
+
+        // Join as many boxes as fit the rec width cap; the rest start a new crop
+        size_t start = 0;
+        while (start < group.size()) {
+            size_t end = start;
+            int total = 0;
+            while (end < group.size()) {
+                int width = pieces[end].empty() ? 0 : pieces[end].cols;
+                int added = total == 0 ? width : total + gap + width;
+                if (end > start && added > max_width) break;
+                total = added;
+                end++;
+            }
+            cv::Mat joined(height, std::max(1, total), CV_8UC3, cv::Scalar(255, 255, 255));
+            std::vector<size_t> members;
+            std::vector<std::pair<int, int> > spans;
+            int x = 0;
+            for (size_t k = start; k < end; k++) {
+                members.push_back(group[k]);
+                if (pieces[k].empty()) {
+                    spans.push_back(std::make_pair(x, x));
+                    continue;
+                }
+                if (x > 0) {
+                    // Gap in the background colour of the neighbouring edges
+                    cv::Scalar edge = (cv::mean(pieces[k].col(0)) + cv::mean(joined.col(x - gap - 1))) * 0.5;
+                    joined(cv::Rect(x - gap, 0, gap, height)).setTo(edge);
+                }
+                pieces[k].copyTo(joined(cv::Rect(x, 0, pieces[k].cols, height)));
+                spans.push_back(std::make_pair(x, x + pieces[k].cols));
+                x += pieces[k].cols + gap;
+            }
+            crops.push_back(joined);
+            crop_boxes.push_back(members);
+            crop_spans.push_back(spans);
+            start = end;
+        }
+    }
+    timing->crops = static_cast<int>(crops.size());
+    timing->crop_ms = elapsedMs(crop_start);
+
+    auto rec_start = std::chrono::high_resolution_clock::now();
+    std::vector<RecognizedText> texts;
+    recognizer.Recognize(crops, &texts);
+    timing->rec_ms = elapsedMs(rec_start);
+
+    lines->assign(boxes.size(), OcrLine());
+    for (size_t i = 0; i < boxes.size(); i++) (*lines)[i].poly = boxes[i].quad;
+    for (size_t c = 0; c < crops.size(); c++) {
+        const RecognizedText& text = texts[c];
+        const std::vector<size_t>& members = crop_boxes[c];
+        std::vector<std::string> characters = utf8Characters(text.text);
+        if (members.size() == 1 || characters.size() != text.char_x.size()) {
+            (*lines)[members[0]].text = text.text;
+            (*lines)[members[0]].score = text.score;
+            continue;
+        }
+        // Each character goes to the box whose span (widened by half a gap) holds its CTC step
+        std::vector<double> score_sums(members.size(), 0.0);
+        std::vector<int> score_counts(members.size(), 0);
+        for (size_t k = 0; k < characters.size(); k++) {
+            float x = text.char_x[k] * crops[c].cols;
+            size_t owner = 0;
+            float best = -1.0f;
+            for (size_t m = 0; m < members.size(); m++) {
+                const std::pair<int, int>& span = crop_spans[c][m];
+                if (span.first == span.second) continue;
+                float outside = x < span.first ? span.first - x : x > span.second ? x - span.second : 0.0f;
+                if (best < 0.0f || outside < best) {
+                    best = outside;
+                    owner = m;
+                }
+            }
+            OcrLine& line = (*lines)[members[owner]];
+            line.text += characters[k];
+            if (characters[k] != " ") {
+                score_sums[owner] += text.char_scores[k];
+                score_counts[owner]++;
+            }
+        }
+        for (size_t m = 0; m < members.size(); m++) {
+            OcrLine& line = (*lines)[members[m]];
+            line.text = trimSpaces(line.text);
+            line.score = score_counts[m] > 0 ? static_cast<float>(score_sums[m] / score_counts[m]) : 0.0f;
+        }
+    }
+}
+
+BoxMergeSummary runBoxMergeBenchmark(const std::vector<std::string>& images,
+                                     TextDetector& detector,
+                                     TextRecognizer& recognizer,
+                                     const DetectorConfig& config,
+                                     const BoxMergeOptions& options,
+                                     int runs,
+                                     const std::string& output_dir) {
+    BoxMergeSummary summary;
+    if (runs < 1) runs = 1;
+    const std::string separate_dir = output_dir + "separate/";
+    const std::string merged_dir = output_dir + "merged/";
+    mkdir(output_dir.c_str(), 0755);
+    mkdir(separate_dir.c_str(), 0755);
+    mkdir(merged_dir.c_str(), 0755);
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            DecodedImage decoded;
+            if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image");
+            const cv::Mat& image = decoded.image;
+            std::vector<DetectedBox> boxes;
+            detector.Detect(image, config, &boxes);
+
+            std::vector<OcrLine> separate_lines, merged_lines;
+            BoxMergeTiming separate_run, merged_run;
+            BoxMergeTiming separate, merged;
+            for (int run = 0; run < runs; run++) {
+                recognizeSeparate(image, boxes, recognizer, &separate_lines, &separate_run);
+                recognizeMerged(image, boxes, recognizer, options, &merged_lines, &merged_run);
+                addTiming(separate_run, 1.0 / runs, &separate);
+                addTiming(merged_run, 1.0 / runs, &merged);
+            }
+            saveOcrLines(separate_dir + documentStem(image_path) + "_res.json", image_path, separate_lines);
+            saveOcrLines(merged_dir + documentStem(image_path) + "_res.json", image_path, merged_lines);
+
+            int mismatches = 0;
+            for (size_t i = 0; i < separate_lines.size(); i++) {
+                if (separate_lines[i].text != merged_lines[i].text) mismatches++;
+            }
+
+            summary.images++;
+            summary.text_mismatches += mismatches;
+            addTiming(separate, 1.0, &summary.separate);
+            addTiming(merged, 1.0, &summary.merged);
+            summary.separate.boxes += separate_run.boxes;
+            summary.separate.crops += separate_run.crops;
+            summary.merged.boxes += merged_run.boxes;
+            summary.merged.crops += merged_run.crops;
+
+            std::cout << "BOX_MERGE_RESULT:{\"filename\":\"" << filename
+                      << "\",\"boxes\":" << boxes.size()
+                      << ",\"merged_crops\":" << merged_run.crops
+                      << ",\"separate_crop_ms\":" << std::fixed << std::setprecision(2) << separate.crop_ms
+                      << ",\"separate_rec_ms\":" << separate.rec_ms
+                      << ",\"merged_crop_ms\":" << merged.crop_ms
+                      << ",\"merged_rec_ms\":" << merged.rec_ms
+                      << ",\"text_mismatches\":" << mismatches << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Box merge benchmark failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "OcrResultJson.h"
+#include "TextDetector.h"
+#include "TextRecognizer.h"
+#include <string>
+#include <vector>
+
+struct BoxMergeOptions {
+    double max_height_ratio = 1.3;  // taller / shorter box height
+    double max_baseline_shift = 0.25; // bottom edge offset, in box heights
+    double max_gap = 3.0;           // horizontal gap between neighbours, in box heights
+    double max_angle = 5.0;         // boxes tilted more than this (degrees) are left alone
+};
+
+// Helper function to group det boxes (reading order) into runs of neighbours
+// on one baseline with about the same height; groups[i] lists box indices left to right
+void groupCollinearBoxes(const std::vector<DetectedBox>& boxes, const BoxMergeOptions& options,
+                         std::vector<std::vector<size_t> >* groups);
+
+struct BoxMergeTiming {
+    double crop_ms = 0.0;
+    double rec_ms = 0.0;
+    int boxes = 0;
+    int crops = 0; // rec inputs after merging
+};
+
+// Every group becomes one rec crop: its boxes are cut at the rec input height
+// and joined left to right with a short background gap, so rec sees the line
+// once. The CTC step of each character places it back in the box it came
+// from; lines come out one per det box, as without merging.
+void recognizeMerged(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextRecognizer& recognizer,
+                     const BoxMergeOptions& options, std::vector<OcrLine>* lines, BoxMergeTiming* timing);
+
+struct BoxMergeSummary {
+    int images = 0;
+    int failed = 0;
+    int text_mismatches = 0; // boxes read differently after merging
+    BoxMergeTiming separate; // sums of per-image averages
+    BoxMergeTiming merged;
+};
+
+// Detects each image once, then times rec with one crop per box and with
+// merged crops `runs` times each, and prints a BOX_MERGE_RESULT line per image.
+// Results are saved as <output_dir>separate/<stem>_res.json and <output_dir>merged/<stem>_res.json.
+BoxMergeSummary runBoxMergeBenchmark(const std::vector<std::string>& images,
+                                     TextDetector& detector,
+                                     TextRecognizer& recognizer,
+                                     const DetectorConfig& config,
+                                     const BoxMergeOptions& options,
+                                     int runs,
+                                     const std::string& output_dir);
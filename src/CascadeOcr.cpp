@@ -0,0 +1,143 @@
+#include "CascadeOcr.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PageStream.h"
+#include "SpooledPredict.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+struct CascadePass {
+    std::vector<OcrLine> lines;
+    int fallback_lines = 0;
+    int improved_lines = 0;
+    bool page_fallback = false;
+    double first_pass_ms = 0.0;
+    double fallback_ms = 0.0;
+};
+
+// `image` is the decoded page, used only to cut fallback crops
+void runCascade(const std::string& image_path, const cv::Mat& image, PaddleOCR& first_pass, PaddleOCR& server_page,
+                TextRecognizer& server_rec, const CascadeOptions& options, const std::string& spool_dir,
+                CascadePass* pass) {
+    predictImageFile(first_pass, image_path, spool_dir, &pass->lines, &pass->first_pass_ms);
+
+    std::vector<size_t> unsure;
+    for (size_t i = 0; i < pass->lines.size(); i++) {
+        if (pass->lines[i].score < options.rec_threshold) unsure.push_back(i);
+    }
+    if (unsure.empty()) return;
+
+    auto fallback_start = std::chrono::high_resolution_clock::now();
+    if (options.det_cascade && unsure.size() > options.page_fallback_ratio * pass->lines.size()) {
+        // Too much of the page is unsure; the mobile boxes are probably off too
+        pass->page_fallback = true;
+        pass->lines.clear();
+        double page_ms = 0.0;
+        predictImageFile(server_page, image_path, spool_dir, &pass->lines, &page_ms);
+        pass->fallback_ms = elapsedMs(fallback_start);
+        return;
+    }
+
+    std::vector<cv::Mat> crops;
+    for (size_t index : unsure) {
+        crops.push_back(cropTextRegion(image, pass->lines[index].poly));
+    }
+    std::vector<RecognizedText> texts;
+    server_rec.Recognize(crops, &texts);
+    for (size_t i = 0; i < unsure.size(); i++) {
+        OcrLine& line = pass->lines[unsure[i]];
+        // Crops skip the textline orientation step, so keep whichever model is more sure
+        if (texts[i].score > line.score) {
+            line.text = texts[i].text;
+            line.score = texts[i].score;
+            pass->improved_lines++;
+        }
+    }
+    pass->fallback_lines = static_cast<int>(unsure.size());
+    pass->fallback_ms = elapsedMs(fallback_start);
+}
+
+}  // namespace
+
+CascadeSummary runCascadeOcr(const std::vector<std::string>& images,
+                             PaddleOCR& first_pass,
+                             PaddleOCR& server_page,
+                             TextRecognizer& server_rec,
+                             const CascadeOptions& options,
+                             int runs,
+                             const std::string& output_dir) {
+    CascadeSummary summary;
+    if (runs < 1) runs = 1;
+    const std::string server_dir = output_dir + "server/";
+    const std::string cascade_dir = output_dir + "cascade/";
+    mkdir(output_dir.c_str(), 0755);
+    mkdir(server_dir.c_str(), 0755);
+    mkdir(cascade_dir.c_str(), 0755);
+    const std::string spool_dir = spoolDirectory(output_dir);
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            // Decoded once for the fallback crops, outside the timed runs
+            DecodedImage decoded;
+            if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image for fallback crops");
+            const cv::Mat& image = decoded.image;
+
+            std::vector<OcrLine> server_lines;
+            double server_ms = 0.0;
+            for (int run = 0; run < runs; run++) {
+                server_lines.clear();
+                double predict_ms = 0.0;
+                auto start = std::chrono::high_resolution_clock::now();
+                predictImageFile(server_page, image_path, spool_dir, &server_lines, &predict_ms);
+                server_ms += elapsedMs(start);
+            }
+
+            CascadePass pass;
+            double total_ms = 0.0;
+            double first_ms = 0.0;
+            double fallback_ms = 0.0;
+            for (int run = 0; run < runs; run++) {
+                pass = CascadePass();
+                auto start = std::chrono::high_resolution_clock::now();
+                runCascade(image_path, image, first_pass, server_page, server_rec, options, spool_dir, &pass);
+                total_ms += elapsedMs(start);
+                first_ms += pass.first_pass_ms;
+                fallback_ms += pass.fallback_ms;
+            }
+            double avg_ms = total_ms / runs;
+            saveOcrLines(server_dir + documentStem(image_path) + "_res.json", image_path, server_lines);
+            saveOcrLines(cascade_dir + documentStem(image_path) + "_res.json", image_path, pass.lines);
+
+            summary.images++;
+            summary.lines += static_cast<int>(pass.lines.size());
+            summary.fallback_lines += pass.fallback_lines;
+            summary.improved_lines += pass.improved_lines;
+            summary.page_fallbacks += pass.page_fallback ? 1 : 0;
+            summary.total_ms += avg_ms;
+            summary.first_pass_ms += first_ms / runs;
+            summary.fallback_ms += fallback_ms / runs;
+            summary.server_ms += server_ms / runs;
+
+            std::cout << "CASCADE_RESULT:{\"filename\":\"" << filename
+                      << "\",\"cascade_ms\":" << std::fixed << std::setprecision(2) << avg_ms
+                      << ",\"first_pass_ms\":" << first_ms / runs
+                      << ",\"fallback_ms\":" << fallback_ms / runs
+                      << ",\"server_ms\":" << server_ms / runs
+                      << ",\"lines\":" << pass.lines.size()
+                      << ",\"fallback_lines\":" << pass.fallback_lines
+                      << ",\"improved_lines\":" << pass.improved_lines
+                      << ",\"page_fallback\":" << (pass.page_fallback ? "true" : "false") << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Cascade OCR failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
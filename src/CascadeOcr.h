@@ -0,0 +1,41 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include "TextRecognizer.h"
+#include <string>
+#include <vector>
+
+struct CascadeOptions {
+    double rec_threshold = 0.9;       // lines with a mobile rec score below this go to server rec
+    bool det_cascade = false;         // first pass also uses mobile det
+    double page_fallback_ratio = 0.3; // with det_cascade: low-score line share above which the page reruns on server det/rec
+};
+
+struct CascadeSummary {
+    int images = 0;
+    int failed = 0;
+    int lines = 0;
+    int fallback_lines = 0; // re-recognized by the server model
+    int improved_lines = 0; // fallback result kept (higher score than mobile)
+    int page_fallbacks = 0; // whole page rerun on the server pipeline (det cascade)
+    double total_ms = 0.0;  // sum of per-image averages
+    double first_pass_ms = 0.0;
+    double fallback_ms = 0.0;
+    double server_ms = 0.0; // pure-server baseline on the same pipeline settings, sum of per-image averages
+};
+
+// Mobile-first OCR: `first_pass` (mobile rec, and mobile det with
+// det_cascade) runs on every page, then only lines whose CTC score is below
+// the threshold are cropped and re-recognized by `server_rec`. With
+// det_cascade, pages where too many lines are unsure rerun whole on
+// `server_page`. The baseline is `server_page` alone, built with the same
+// pipeline settings as `first_pass` so the two differ only in the models.
+// Each image runs `runs` times both ways; the averages are reported on a
+// CASCADE_RESULT line. Results are saved as <output_dir>{server,cascade}/<stem>_res.json.
+CascadeSummary runCascadeOcr(const std::vector<std::string>& images,
+                             PaddleOCR& first_pass,
+                             PaddleOCR& server_page,
+                             TextRecognizer& server_rec,
+                             const CascadeOptions& options,
+                             int runs,
+                             const std::string& output_dir);
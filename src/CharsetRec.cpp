@@ -0,0 +1,186 @@
+#include "CharsetRec.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <utility>
+
+namespace {
+
+// Helper function to score aligned text pairs with calculate_acc.py --line_pairs, so field
+// accuracy uses the same normalization and edit distance as the page metrics
+bool scoreLinePairs(const std::vector<std::pair<std::string, std::string> >& pairs, const std::string& labels_path,
+                    const std::string& output_dir, std::vector<double>* accuracies) {
+    const std::string pairs_path = output_dir + "line_pairs.jsonl";
+    std::ofstream out(pairs_path);
+    for (const auto& pair : pairs) {
+        nlohmann::json record;
+        record["reference"] = pair.first;
+        record["hypothesis"] = pair.second;
+        out << record.dump() << "\n";
+    }
+    out.close();
+    if (!out) return false;
+
+    std::string command = "python " + get_root_path() + "/scripts/calculate_acc.py";
+    command += " --ground_truth \"" + labels_path + "\"";
+    command += " --output_dir \"" + output_dir + "\"";
+    command += " --line_pairs \"" + pairs_path + "\"";
+    std::string result_str;
+    if (!ExecuteCommand(command, &result_str)) return false;
+
+    accuracies->assign(pairs.size(), 0.0);
+    std::istringstream iss(result_str);
+    std::string line;
+    const std::string prefix = "LINE_ACC: ";
+    size_t scored = 0;
+    while (std::getline(iss, line)) {
+        if (line.compare(0, prefix.size(), prefix) != 0) continue;
+        nlohmann::json record = nlohmann::json::parse(line.substr(prefix.size()), nullptr, false);
+        if (record.is_discarded()) continue;
+        size_t index = record.value("index", pairs.size());
+        if (index >= pairs.size()) continue;
+        (*accuracies)[index] = record.value("character_accuracy", 0.0);
+        scored++;
+    }
+    return scored == pairs.size();
+}
+
+struct Field {
+    cv::Mat crop;
+    std::string text;
+};
+
+}  // namespace
+
+CharsetRecSummary runCharsetRecBenchmark(const std::vector<std::string>& images,
+                                         const std::string& labels_path,
+                                         const std::vector<std::string>& charset_specs,
+                                         TextRecognizer& recognizer,
+                                         int runs,
+                                         const std::string& output_dir) {
+    CharsetRecSummary summary;
+    if (runs < 1) runs = 1;
+    mkdir(output_dir.c_str(), 0755);
+    summary.dictionary_classes = recognizer.NumClasses();
+
+    std::ifstream in(labels_path);
+    nlohmann::json labels = nlohmann::json::parse(in, nullptr, false);
+    if (labels.is_discarded() || !labels.is_object()) {
+        throw std::runtime_error("cannot read " + labels_path);
+    }
+
+    std::vector<RecCharset> charsets;
+    for (const auto& spec : charset_specs) charsets.push_back(recognizer.Charset(spec));
+
+    // Fields grouped by the first charset their label text fits
+    std::vector<std::vector<Field> > fields(charsets.size());
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        if (!labels.contains(filename)) continue;
+        DecodedImage decoded;
+        if (!decodeImage(image_path, 0, &decoded)) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Cannot decode " << image_path << std::endl;
+            continue;
+        }
+        const cv::Mat& image = decoded.image;
+        summary.images++;
+        for (const auto& entry : labels[filename]) {
+            if (!entry.contains("text") || !entry.contains("bbox")) continue;
+            const std::string text = entry["text"].get<std::string>();
+            if (text.empty() || entry["bbox"].size() != 4) continue;
+            std::vector<std::string> characters = utf8Characters(text);
+            for (size_t c = 0; c < charsets.size(); c++) {
+                bool fits = true;
+                for (const auto& character : characters) fits = fits && charsets[c].characters.count(character) > 0;
+                if (!fits) continue;
+                std::vector<cv::Point> quad;
+                for (const auto& point : entry["bbox"]) quad.push_back(cv::Point(point[0].get<int>(), point[1].get<int>()));
+                Field field;
+                field.crop = cropTextRegion(image, quad);
+                field.text = text;
+                if (!field.crop.empty()) fields[c].push_back(field);
+                break;
+            }
+        }
+    }
+
+    // Texts per charset: [c][i] = (full dictionary, restricted) reading of fields[c][i]
+    std::vector<std::vector<std::pair<std::string, std::string> > > readings(charsets.size());
+    for (size_t c = 0; c < charsets.size(); c++) {
+        CharsetFieldStats& stats = summary.charsets[charsets[c].name];
+        stats.fields = static_cast<int>(fields[c].size());
+        stats.classes = static_cast<int>(charsets[c].classes.size());
+        if (fields[c].empty()) continue;
+
+        std::vector<cv::Mat> crops;
+        for (const auto& field : fields[c]) crops.push_back(field.crop);
+        std::vector<const RecCharset*> restricted(crops.size(), &charsets[c]);
+        std::vector<RecognizedText> full_texts, restricted_texts;
+        for (int run = 0; run < runs; run++) {
+            double decode_before = recognizer.DecodeMs();
+            auto full_start = std::chrono::high_resolution_clock::now();
+            recognizer.Recognize(crops, &full_texts);
+            stats.full_ms += elapsedMs(full_start) / runs;
+            stats.full_decode_ms += (recognizer.DecodeMs() - decode_before) / runs;
+
+            decode_before = recognizer.DecodeMs();
+            auto restricted_start = std::chrono::high_resolution_clock::now();
+            recognizer.Recognize(crops, &restricted_texts, restricted);
+            stats.restricted_ms += elapsedMs(restricted_start) / runs;
+            stats.restricted_decode_ms += (recognizer.DecodeMs() - decode_before) / runs;
+        }
+
+        for (size_t i = 0; i < fields[c].size(); i++) {
+            readings[c].push_back(std::make_pair(full_texts[i].text, restricted_texts[i].text));
+            stats.full_exact += full_texts[i].text == fields[c][i].text ? 1 : 0;
+            stats.restricted_exact += restricted_texts[i].text == fields[c][i].text ? 1 : 0;
+        }
+    }
+
+    // Character accuracy from the shared scorer, both readings of every field in one call
+    std::vector<std::pair<std::string, std::string> > pairs;
+    for (size_t c = 0; c < charsets.size(); c++) {
+        for (size_t i = 0; i < readings[c].size(); i++) {
+            pairs.push_back(std::make_pair(fields[c][i].text, readings[c][i].first));
+            pairs.push_back(std::make_pair(fields[c][i].text, readings[c][i].second));
+        }
+    }
+    std::vector<double> accuracies;
+    if (!pairs.empty() && !scoreLinePairs(pairs, labels_path, output_dir, &accuracies)) {
+        throw std::runtime_error("field accuracy evaluation failed");
+    }
+
+    size_t pair_index = 0;
+    for (size_t c = 0; c < charsets.size(); c++) {
+        CharsetFieldStats& stats = summary.charsets[charsets[c].name];
+        if (readings[c].empty()) continue;
+        for (size_t i = 0; i < readings[c].size(); i++) {
+            stats.full_accuracy += accuracies[pair_index++];
+            stats.restricted_accuracy += accuracies[pair_index++];
+        }
+        stats.full_accuracy /= readings[c].size();
+        stats.restricted_accuracy /= readings[c].size();
+
+        std::cout << "CHARSET_REC_RESULT:{\"charset\":\"" << charsets[c].name
+                  << "\",\"fields\":" << stats.fields
+                  << ",\"classes\":" << stats.classes
+                  << ",\"full_ms\":" << std::fixed << std::setprecision(2) << stats.full_ms
+                  << ",\"restricted_ms\":" << stats.restricted_ms
+                  << ",\"full_decode_ms\":" << stats.full_decode_ms
+                  << ",\"restricted_decode_ms\":" << stats.restricted_decode_ms
+                  << ",\"full_accuracy\":" << std::setprecision(4) << stats.full_accuracy
+                  << ",\"restricted_accuracy\":" << stats.restricted_accuracy
+                  << ",\"full_exact\":" << stats.full_exact
+                  << ",\"restricted_exact\":" << stats.restricted_exact << "}" << std::endl;
+    }
+    return summary;
+}
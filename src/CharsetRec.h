@@ -0,0 +1,39 @@
+#pragma once
+
+#include "TextRecognizer.h"
+#include <map>
+#include <string>
+#include <vector>
+
+struct CharsetFieldStats {
+    int fields = 0;
+    int classes = 0;               // allowed classes incl. blank
+    int full_exact = 0;            // fields read exactly right
+    int restricted_exact = 0;
+    double full_accuracy = 0.0;    // mean character accuracy, scored by calculate_acc.py
+    double restricted_accuracy = 0.0;
+    double full_ms = 0.0;          // Recognize over all fields of this charset, per run
+    double restricted_ms = 0.0;
+    double full_decode_ms = 0.0;   // CTC decode share of the above
+    double restricted_decode_ms = 0.0;
+};
+
+struct CharsetRecSummary {
+    int images = 0;
+    int failed = 0;
+    int dictionary_classes = 0;
+    std::map<std::string, CharsetFieldStats> charsets;
+};
+
+// Restricted fields from labels.json: every labelled line of `images` whose
+// text only uses characters of one of `charset_specs` (first match wins) is
+// cropped from its bbox and recognized `runs` times with the full dictionary
+// and with CTC decoding constrained to that charset (the model and its head run
+// unchanged). Prints a CHARSET_REC_RESULT line per charset with accuracy from
+// calculate_acc.py (pairs written to output_dir) and rec / decode time.
+CharsetRecSummary runCharsetRecBenchmark(const std::vector<std::string>& images,
+                                         const std::string& labels_path,
+                                         const std::vector<std::string>& charset_specs,
+                                         TextRecognizer& recognizer,
+                                         int runs,
+                                         const std::string& output_dir);
@@ -0,0 +1,214 @@
+#include "CoarseToFineDet.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "OcrResultJson.h"
+#include "PageStream.h"
+#include "RegionOcr.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+double rectIou(const cv::Rect& a, const cv::Rect& b) {
+    double inter = (a & b).area();
+    double uni = a.area() + b.area() - inter;
+    return uni > 0 ? inter / uni : 0.0;
+}
+
+}  // namespace
+
+void detectCoarseToFine(TextDetector& detector, const cv::Mat& image, const DetectorConfig& config,
+                        const CoarseToFineOptions& options, CoarseToFineResult* result) {
+    detectCoarseToFine(detector, image, image, config, options, result);
+}
+
+void detectCoarseToFine(TextDetector& detector, const cv::Mat& image, const cv::Mat& coarse_image,
+                        const DetectorConfig& config, const CoarseToFineOptions& options,
+                        CoarseToFineResult* result) {
+    *result = CoarseToFineResult();
+    const cv::Rect page(0, 0, image.cols, image.rows);
+
+    // Coarse pass: longer side capped, everything else as configured
+    DetectorConfig coarse_config = config;
+    coarse_config.limit_type = "max";
+    coarse_config.limit_side_len = options.coarse_side;
+    auto coarse_start = std::chrono::high_resolution_clock::now();
+    std::vector<DetectedBox> coarse;
+    detector.Detect(coarse_image, coarse_config, &coarse);
+    if (coarse_image.cols != image.cols || coarse_image.rows != image.rows) {
+        const double sx = static_cast<double>(image.cols) / coarse_image.cols;
+        const double sy = static_cast<double>(image.rows) / coarse_image.rows;
+        for (auto& box : coarse) {
+            for (auto& p : box.quad) p = cv::Point(static_cast<int>(p.x * sx + 0.5), static_cast<int>(p.y * sy + 0.5));
+        }
+    }
+    result->coarse_ms = elapsedMs(coarse_start);
+
+    std::vector<cv::Rect> regions;
+    std::vector<int> heights;
+    for (const auto& box : coarse) {
+        cv::Rect bounds = cv::boundingRect(box.quad);
+        heights.push_back(bounds.height);
+        cv::Rect padded(bounds.x - options.region_margin, bounds.y - options.region_margin,
+                        bounds.width + 2 * options.region_margin, bounds.height + 2 * options.region_margin);
+        regions.push_back(padded & page);
+    }
+    mergeOverlappingRects(&regions);
+    double region_area = 0.0;
+    for (const auto& region : regions) region_area += region.area();
+
+    const double coarse_scale = static_cast<double>(options.coarse_side) / std::max(image.rows, image.cols);
+    if (!heights.empty()) {
+        std::nth_element(heights.begin(), heights.begin() + heights.size() / 2, heights.end());
+    }
+    if (coarse.empty()) {
+        result->fallback = "no_text_found";
+    } else if (coarse_scale < 1.0 && heights[heights.size() / 2] * coarse_scale < options.min_text_px) {
+        result->fallback = "text_too_small";
+    } else if (static_cast<int>(regions.size()) > options.max_regions) {
+        result->fallback = "too_many_regions";
+    } else if (region_area > options.full_page_ratio * page.area()) {
+        result->fallback = "regions_cover_page";
+    }
+
+    auto fine_start = std::chrono::high_resolution_clock::now();
+    if (!result->fallback.empty()) {
+        detector.Detect(image, config, &result->boxes);
+    } else {
+        result->regions = static_cast<int>(regions.size());
+        for (const auto& region : regions) {
+            std::vector<DetectedBox> fine;
+            detector.Detect(image(region), config, &fine);
+            for (auto& box : fine) {
+                for (auto& point : box.quad) point = point + region.tl();
+                result->boxes.push_back(box);
+            }
+        }
+        std::sort(result->boxes.begin(), result->boxes.end(), [](const DetectedBox& a, const DetectedBox& b) {
+            return a.quad[0].y != b.quad[0].y ? a.quad[0].y < b.quad[0].y : a.quad[0].x < b.quad[0].x;
+        });
+    }
+    result->fine_ms = elapsedMs(fine_start);
+}
+
+double boxRecall(const std::vector<DetectedBox>& reference, const std::vector<DetectedBox>& candidates) {
+    if (reference.empty()) return 1.0;
+    std::vector<bool> used(candidates.size(), false);
+    int matched = 0;
+    for (const auto& ref : reference) {
+        cv::Rect ref_rect = cv::boundingRect(ref.quad);
+        int best = -1;
+        double best_iou = 0.5;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (used[i]) continue;
+            double iou = rectIou(ref_rect, cv::boundingRect(candidates[i].quad));
+            if (iou >= best_iou) {
+                best_iou = iou;
+                best = static_cast<int>(i);
+            }
+        }
+        if (best >= 0) {
+            used[best] = true;
+            matched++;
+        }
+    }
+    return static_cast<double>(matched) / reference.size();
+}
+
+CoarseToFineSummary runCoarseToFineBenchmark(const std::vector<std::string>& images,
+                                             TextDetector& detector,
+                                             TextRecognizer& recognizer,
+                                             const DetectorConfig& config,
+                                             const CoarseToFineOptions& options,
+                                             int runs,
+                                             const std::string& output_dir) {
+    CoarseToFineSummary summary;
+    if (runs < 1) runs = 1;
+    mkdir(output_dir.c_str(), 0755);
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            // Both sides are timed from the file: full-page det needs the full decode, coarse-to-fine
+            // needs the reduced decode for its coarse pass plus the full decode for the fine pass
+            DecodedImage decoded;
+            DecodedImage coarse_decoded;
+            std::vector<DetectedBox> full_boxes;
+            CoarseToFineResult c2f;
+            double full_ms = 0.0;
+            double c2f_ms = 0.0;
+            double coarse_ms = 0.0;
+            double coarse_decode_ms = 0.0;
+            for (int run = 0; run < runs; run++) {
+                auto start = std::chrono::high_resolution_clock::now();
+                if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image");
+                detector.Detect(decoded.image, config, &full_boxes);
+                full_ms += elapsedMs(start);
+
+                start = std::chrono::high_resolution_clock::now();
+                if (!decodeImage(image_path, options.coarse_side, &coarse_decoded) ||
+                    !decodeImage(image_path, 0, &decoded)) {
+                    throw std::runtime_error("cannot decode image");
+                }
+                const double decode_ms = elapsedMs(start);
+                detectCoarseToFine(detector, decoded.image, coarse_decoded.image, config, options, &c2f);
+                c2f_ms += decode_ms + c2f.coarse_ms + c2f.fine_ms;
+                coarse_ms += c2f.coarse_ms;
+                coarse_decode_ms += coarse_decoded.decode_ms;
+            }
+            const cv::Mat& image = decoded.image;
+            full_ms /= runs;
+            c2f_ms /= runs;
+            coarse_ms /= runs;
+            coarse_decode_ms /= runs;
+            double recall = boxRecall(full_boxes, c2f.boxes);
+
+            // Recognize the coarse-to-fine boxes so calculate_acc.py can score them end to end
+            std::vector<cv::Mat> crops;
+            for (const auto& box : c2f.boxes) crops.push_back(cropTextRegion(image, box.quad));
+            std::vector<RecognizedText> texts;
+            recognizer.Recognize(crops, &texts);
+            std::vector<OcrLine> lines;
+            for (size_t i = 0; i < c2f.boxes.size(); i++) {
+                OcrLine line;
+                line.poly = c2f.boxes[i].quad;
+                line.text = texts[i].text;
+                line.score = texts[i].score;
+                lines.push_back(line);
+            }
+            saveOcrLines(output_dir + documentStem(image_path) + "_res.json", image_path, lines);
+
+            summary.images++;
+            summary.full_det_ms += full_ms;
+            summary.c2f_det_ms += c2f_ms;
+            summary.recall_sum += recall;
+            if (c2f.fallback.empty()) {
+                summary.refined++;
+                summary.refined_full_det_ms += full_ms;
+                summary.refined_c2f_det_ms += c2f_ms;
+            } else {
+                summary.fallbacks++;
+            }
+
+            std::cout << "C2F_RESULT:{\"filename\":\"" << filename
+                      << "\",\"full_det_ms\":" << std::fixed << std::setprecision(2) << full_ms
+                      << ",\"c2f_det_ms\":" << c2f_ms
+                      << ",\"coarse_ms\":" << coarse_ms
+                      << ",\"coarse_decode_ms\":" << coarse_decode_ms
+                      << ",\"regions\":" << c2f.regions
+                      << ",\"fallback\":\"" << (c2f.fallback.empty() ? "none" : c2f.fallback)
+                      << "\",\"full_boxes\":" << full_boxes.size()
+                      << ",\"c2f_boxes\":" << c2f.boxes.size()
+                      << ",\"recall_vs_full\":" << std::setprecision(4) << recall << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Coarse-to-fine det failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
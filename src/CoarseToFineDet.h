@@ -0,0 +1,64 @@
+#pragma once
+
+#include "TextDetector.h"
+#include "TextRecognizer.h"
+#include <string>
+#include <vector>
+
+struct CoarseToFineOptions {
+    int coarse_side = 640;        // longer side of the low-resolution pass
+    int region_margin = 24;       // full resolution padding around coarse boxes
+    double full_page_ratio = 0.5; // fall back when regions cover more of the page than this
+    int max_regions = 16;         // fall back when the page is too busy for per-region det
+    int min_text_px = 8;          // fall back when the median coarse box is shorter than this
+};
+
+struct CoarseToFineResult {
+    std::vector<DetectedBox> boxes;
+    int regions = 0;
+    std::string fallback; // empty when the fine pass ran on regions, else why the full page was used
+    double coarse_ms = 0.0;
+    double fine_ms = 0.0;
+};
+
+// Two-pass detection: a low-resolution pass over the whole page finds text
+// regions, then full-resolution det runs only on crops around them. Pages
+// the coarse pass cannot vouch for (no text found, text too small, too many
+// or too large regions) get full-page det instead.
+void detectCoarseToFine(TextDetector& detector, const cv::Mat& image, const DetectorConfig& config,
+                        const CoarseToFineOptions& options, CoarseToFineResult* result);
+
+// Same, with the coarse pass run on `coarse_image`: the page decoded with
+// decodeImage(path, options.coarse_side), i.e. already reduced in the DCT
+// domain for JPEGs. Coarse boxes are scaled back to `image` coordinates.
+void detectCoarseToFine(TextDetector& detector, const cv::Mat& image, const cv::Mat& coarse_image,
+                        const DetectorConfig& config, const CoarseToFineOptions& options,
+                        CoarseToFineResult* result);
+
+// Helper function to get the share of reference boxes matched by a candidate
+// box with bounding-rect IoU >= 0.5 (one-to-one, greedy)
+double boxRecall(const std::vector<DetectedBox>& reference, const std::vector<DetectedBox>& candidates);
+
+struct CoarseToFineSummary {
+    int images = 0;
+    int failed = 0;
+    int refined = 0;   // pages that used the region pass
+    int fallbacks = 0; // pages that fell back to full-page det
+    double full_det_ms = 0.0; // full decode + det
+    double c2f_det_ms = 0.0;  // reduced + full decode + coarse and fine det
+    double refined_full_det_ms = 0.0; // the same two sums restricted to refined pages
+    double refined_c2f_det_ms = 0.0;
+    double recall_sum = 0.0; // against full-page det boxes
+};
+
+// Benchmarks full-page against coarse-to-fine det on each image, both timed
+// from the file including their decodes (average of `runs`), recognizes the
+// coarse-to-fine boxes and saves them as <output_dir><stem>_res.json, and
+// prints a C2F_RESULT line per image.
+CoarseToFineSummary runCoarseToFineBenchmark(const std::vector<std::string>& images,
+                                             TextDetector& detector,
+                                             TextRecognizer& recognizer,
+                                             const DetectorConfig& config,
+                                             const CoarseToFineOptions& options,
+                                             int runs,
+                                             const std::string& output_dir);
@@ -0,0 +1,300 @@
+#include "DocPreprocessor.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PageStream.h"
+#include "PaddleStage.h"
+#include "SpooledPredict.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+// Shared thumbnail size: above doc_ori's 256px resize and UVDoc's 488x712 working grid
+const int kThumbnailShortSide = 512;
+
+// Helper function to downscale so the shorter side is `short_side` (never upscales)
+cv::Mat shrinkToShortSide(const cv::Mat& image, int short_side) {
+    int current = std::min(image.cols, image.rows);
+    if (current <= short_side) return image;
+    double scale = static_cast<double>(short_side) / current;
+    cv::Mat resized;
+    cv::resize(image, resized, cv::Size(std::max(1, static_cast<int>(image.cols * scale + 0.5)),
+                                        std::max(1, static_cast<int>(image.rows * scale + 0.5))),
+               0, 0, cv::INTER_AREA);
+    return resized;
+}
+
+// Helper function to pack a BGR image into a 3xHxW RGB tensor with (x / 255 - mean) / std
+void toRgbTensor(const cv::Mat& image, const float mean[3], const float stddev[3], float* tensor) {
+    const int height = image.rows;
+    const int width = image.cols;
+    for (int y = 0; y < height; y++) {
+        const uchar* row = image.ptr<uchar>(y);
+        for (int x = 0; x < width; x++) {
+            for (int c = 0; c < 3; c++) {
+                float value = row[x * 3 + (2 - c)] / 255.0f;
+                tensor[(static_cast<size_t>(c) * height + y) * width + x] = (value - mean[c]) / stddev[c];
+            }
+        }
+    }
+}
+
+// Helper function to run a predictor whose input is already filled; returns its first output
+const float* runPredictor(StagePredictor& predictor, std::vector<int>* shape) {
+    if (!predictor.Run()) {
+        throw std::runtime_error("document preprocessing predictor failed");
+    }
+    return predictor.Output(shape);
+}
+
+}  // namespace
+
+void undoPageRotation(cv::Mat* image, int angle) {
+    // Same direction as the pipeline: the detected angle is undone counterclockwise.
+    // Always into a new buffer, so pixels shared with the caller are left alone.
+    cv::Mat rotated;
+    if (angle == 90) {
+        cv::rotate(*image, rotated, cv::ROTATE_90_COUNTERCLOCKWISE);
+    } else if (angle == 180) {
+        cv::rotate(*image, rotated, cv::ROTATE_180);
+    } else if (angle == 270) {
+        cv::rotate(*image, rotated, cv::ROTATE_90_CLOCKWISE);
+    } else {
+        return;
+    }
+    *image = rotated;
+}
+
+DocPreprocessor::DocPreprocessor(const std::string& orientation_model_dir, const std::string& unwarp_model_dir,
+                                 const std::string& device, int cpu_threads) {
+    YAML::Node config = loadStageConfig(orientation_model_dir);
+    YAML::Node transforms = config["PreProcess"]["transform_ops"];
+    for (size_t i = 0; i < transforms.size(); i++) {
+        if (transforms[i]["ResizeImage"]["resize_short"]) {
+            resize_short_ = transforms[i]["ResizeImage"]["resize_short"].as<int>();
+        }
+        if (transforms[i]["CropImage"]["size"]) {
+            crop_size_ = transforms[i]["CropImage"]["size"].as<int>();
+        }
+    }
+    YAML::Node labels = config["PostProcess"]["Topk"]["label_list"];
+    if (labels.IsSequence() && labels.size() > 0) {
+        angles_.clear();
+        for (size_t i = 0; i < labels.size(); i++) {
+            angles_.push_back(std::atoi(labels[i].as<std::string>().c_str()));
+        }
+    }
+
+    orientation_ = StagePredictor(orientation_model_dir, device, cpu_threads);
+    unwarp_ = StagePredictor(unwarp_model_dir, device, cpu_threads);
+
+    // Which UVDoc export this is decides what it is fed, so settle it before the first page:
+    // from the declared output shape, or else from one small blank run
+    std::vector<int64_t> declared = unwarp_.DeclaredOutputShape();
+    if (declared.size() == 4 && declared[1] > 0) {
+        unwarp_channels_ = static_cast<int>(declared[1]);
+    } else {
+        static const int kProbeSide = 64;
+        unwarp_.Input({1, 3, kProbeSide, kProbeSide}, true);
+        std::vector<int> shape;
+        runPredictor(unwarp_, &shape);
+        if (shape.size() != 4) {
+            throw std::runtime_error("unexpected unwarping output rank");
+        }
+        unwarp_channels_ = shape[1];
+    }
+    if (unwarp_channels_ != 2 && unwarp_channels_ != 3) {
+        throw std::runtime_error("unexpected unwarping output channels: " + std::to_string(unwarp_channels_));
+    }
+}
+
+cv::Mat DocPreprocessor::Process(const std::string& image_path, DocPreprocessTiming* timing, bool orientation,
+                                 bool unwarp) {
+    auto decode_start = std::chrono::high_resolution_clock::now();
+    DecodedImage decoded;
+    if (!decodeImage(image_path, 0, &decoded)) {
+        throw std::runtime_error("cannot decode " + image_path);
+    }
+    cv::Mat page = decoded.image;
+    // The full page is needed anyway, so the thumbnail is a resize of it rather than a second decode
+    cv::Mat thumbnail = shrinkToShortSide(page, kThumbnailShortSide);
+    timing->decode_ms = elapsedMs(decode_start);
+
+    if (orientation) {
+        auto orientation_start = std::chrono::high_resolution_clock::now();
+        std::vector<int> angles;
+        ClassifyOrientations(std::vector<cv::Mat>(1, thumbnail), &angles);
+        timing->angle = angles[0];
+        undoPageRotation(&page, timing->angle);
+        undoPageRotation(&thumbnail, timing->angle);
+        timing->orientation_ms = elapsedMs(orientation_start);
+    }
+    if (!unwarp) return page;
+
+    auto unwarp_start = std::chrono::high_resolution_clock::now();
+    cv::Mat corrected = Unwarp(page, thumbnail, &timing->remapped);
+    timing->unwarp_ms = elapsedMs(unwarp_start);
+    return corrected;
+}
+
+void DocPreprocessor::ClassifyPages(const std::vector<cv::Mat>& pages, std::vector<int>* angles) {
+    std::vector<cv::Mat> thumbnails;
+    for (const auto& page : pages) thumbnails.push_back(shrinkToShortSide(page, kThumbnailShortSide));
+    ClassifyOrientations(thumbnails, angles);
+}
+
+void DocPreprocessor::ClassifyOrientations(const std::vector<cv::Mat>& thumbnails, std::vector<int>* angles) {
+    angles->assign(thumbnails.size(), 0);
+    if (thumbnails.empty()) return;
+
+    // resize_short + center crop, ImageNet normalization; every crop is the same size, so one batch
+    static const float kMean[3] = {0.485f, 0.456f, 0.406f};
+    static const float kStd[3] = {0.229f, 0.224f, 0.225f};
+    const int batch = static_cast<int>(thumbnails.size());
+    const size_t plane = static_cast<size_t>(3) * crop_size_ * crop_size_;
+    float* input = orientation_.Input({batch, 3, crop_size_, crop_size_});
+    for (size_t i = 0; i < thumbnails.size(); i++) {
+        const cv::Mat& thumbnail = thumbnails[i];
+        double scale = static_cast<double>(resize_short_) / std::min(thumbnail.cols, thumbnail.rows);
+        cv::Mat resized;
+        cv::resize(thumbnail, resized, cv::Size(std::max(crop_size_, static_cast<int>(thumbnail.cols * scale + 0.5)),
+                                                std::max(crop_size_, static_cast<int>(thumbnail.rows * scale + 0.5))));
+        cv::Rect crop((resized.cols - crop_size_) / 2, (resized.rows - crop_size_) / 2, crop_size_, crop_size_);
+        toRgbTensor(resized(crop), kMean, kStd, input + plane * i);
+    }
+
+    std::vector<int> shape;
+    const float* probs = runPredictor(orientation_, &shape);
+    if (shape.size() != 2 || shape[0] != batch) {
+        throw std::runtime_error("unexpected document orientation output shape");
+    }
+    const size_t classes = static_cast<size_t>(shape[1]);
+    for (size_t i = 0; i < thumbnails.size(); i++) {
+        const float* scores = probs + i * classes;
+        int best = static_cast<int>(std::max_element(scores, scores + classes) - scores);
+        (*angles)[i] = best < static_cast<int>(angles_.size()) ? angles_[best] : 0;
+    }
+}
+
+cv::Mat DocPreprocessor::Unwarp(const cv::Mat& page, const cv::Mat& thumbnail, bool* remapped) {
+    static const float kZero[3] = {0.0f, 0.0f, 0.0f};
+    static const float kOne[3] = {1.0f, 1.0f, 1.0f};
+    *remapped = false;
+
+    const float* output = nullptr;
+    std::vector<int> shape;
+    if (unwarp_channels_ == 2) {
+        toRgbTensor(thumbnail, kZero, kOne, unwarp_.Input({1, 3, thumbnail.rows, thumbnail.cols}));
+        output = runPredictor(unwarp_, &shape);
+        if (shape.size() != 4 || shape[1] != 2) {
+            throw std::runtime_error("unexpected unwarping output shape");
+        }
+        // Backward map in [-1, 1] (align_corners), upsampled to page pixels
+        const int map_height = shape[2];
+        const int map_width = shape[3];
+        // Headers over the output tensor, only read by the resizes below
+        cv::Mat grid_x(map_height, map_width, CV_32F, const_cast<float*>(output));
+        cv::Mat grid_y(map_height, map_width, CV_32F, const_cast<float*>(output) + static_cast<size_t>(map_height) * map_width);
+        cv::Mat map_x, map_y;
+        cv::resize(grid_x, map_x, page.size(), 0, 0, cv::INTER_LINEAR);
+        cv::resize(grid_y, map_y, page.size(), 0, 0, cv::INTER_LINEAR);
+        map_x.convertTo(map_x, CV_32F, 0.5 * (page.cols - 1), 0.5 * (page.cols - 1));
+        map_y.convertTo(map_y, CV_32F, 0.5 * (page.rows - 1), 0.5 * (page.rows - 1));
+        cv::Mat corrected;
+        cv::remap(page, corrected, map_x, map_y, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+        *remapped = true;
+        return corrected;
+    }
+
+    // Stock export: the model samples its own input, so only a full page gives a full page back
+    toRgbTensor(page, kZero, kOne, unwarp_.Input({1, 3, page.rows, page.cols}));
+    output = runPredictor(unwarp_, &shape);
+    if (shape.size() != 4 || shape[1] != 3) {
+        throw std::runtime_error("unexpected unwarping output shape");
+    }
+    const int height = shape[2];
+    const int width = shape[3];
+    const size_t plane = static_cast<size_t>(height) * width;
+    cv::Mat corrected(height, width, CV_8UC3);
+    for (int y = 0; y < height; y++) {
+        uchar* row = corrected.ptr<uchar>(y);
+        for (int x = 0; x < width; x++) {
+            for (int c = 0; c < 3; c++) {
+                float value = output[c * plane + static_cast<size_t>(y) * width + x] * 255.0f;
+                row[x * 3 + (2 - c)] = cv::saturate_cast<uchar>(value);
+            }
+        }
+    }
+    return corrected;
+}
+
+DocPreprocessSummary runDocPreprocess(const std::vector<std::string>& images,
+                                      DocPreprocessor& preprocessor,
+                                      PaddleOCR& page_ocr,
+                                      int runs,
+                                      const std::map<std::string, double>& pipeline_ms,
+                                      const std::string& output_dir) {
+    DocPreprocessSummary summary;
+    if (runs < 1) runs = 1;
+    mkdir(output_dir.c_str(), 0755);
+    const std::string spool_dir = spoolDirectory(output_dir);
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            DocPreprocessTiming timing;
+            DocPreprocessTiming sum;
+            double ocr_ms = 0.0;
+            double total_ms = 0.0;
+            for (int run = 0; run < runs; run++) {
+                auto start = std::chrono::high_resolution_clock::now();
+                cv::Mat page = preprocessor.Process(image_path, &timing);
+                std::vector<OcrLine> lines;
+                double predict_ms = 0.0;
+                // Keep the JSON of the last run for scoring
+                const bool last_run = run == runs - 1;
+                if (!predictSpooledImage(page_ocr, page, spool_dir, documentStem(image_path), &lines, &predict_ms,
+                                         last_run ? output_dir : "")) {
+                    throw std::runtime_error("pipeline returned no result");
+                }
+                total_ms += elapsedMs(start);
+                ocr_ms += predict_ms;
+                sum.decode_ms += timing.decode_ms;
+                sum.orientation_ms += timing.orientation_ms;
+                sum.unwarp_ms += timing.unwarp_ms;
+            }
+
+            summary.images++;
+            summary.rotated += timing.angle != 0 ? 1 : 0;
+            summary.remapped += timing.remapped ? 1 : 0;
+            summary.decode_ms += sum.decode_ms / runs;
+            summary.orientation_ms += sum.orientation_ms / runs;
+            summary.unwarp_ms += sum.unwarp_ms / runs;
+            summary.ocr_ms += ocr_ms / runs;
+            summary.total_ms += total_ms / runs;
+
+            std::map<std::string, double>::const_iterator pipeline = pipeline_ms.find(filename);
+            std::cout << "DOC_PREPROCESS_RESULT:{\"filename\":\"" << filename
+                      << "\",\"total_ms\":" << std::fixed << std::setprecision(2) << total_ms / runs
+                      << ",\"decode_ms\":" << sum.decode_ms / runs
+                      << ",\"orientation_ms\":" << sum.orientation_ms / runs
+                      << ",\"unwarp_ms\":" << sum.unwarp_ms / runs
+                      << ",\"ocr_ms\":" << ocr_ms / runs;
+            if (pipeline != pipeline_ms.end()) {
+                std::cout << ",\"pipeline_ms\":" << pipeline->second;
+            }
+            std::cout << ",\"angle\":" << timing.angle
+                      << ",\"remapped\":" << (timing.remapped ? "true" : "false") << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Document preprocessing failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
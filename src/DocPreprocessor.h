@@ -0,0 +1,87 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include "PaddleStage.h"
+#include <opencv2/opencv.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct DocPreprocessTiming {
+    double decode_ms = 0.0;      // full page + thumbnail resize
+    double orientation_ms = 0.0; // doc_ori on the thumbnail
+    double unwarp_ms = 0.0;      // UVDoc + applying its result to the full page
+    int angle = 0;               // detected page rotation (0, 90, 180, 270)
+    bool remapped = false;       // UVDoc map applied with one full-resolution remap
+};
+
+// Helper function to rotate a page upright given the doc_ori angle (0, 90, 180, 270)
+void undoPageRotation(cv::Mat* image, int angle);
+
+// Document orientation and unwarping driven from a shared thumbnail. The page
+// is decoded once and the thumbnail is one INTER_AREA resize of it. doc_ori
+// only ever sees the thumbnail. UVDoc sees it too when the exported model
+// returns its backward map (2 channels); the map is then upsampled and
+// applied to the full page in a single remap. The stock export downloaded by
+// compile_dependencies.sh returns the unwarped image (3 channels) and gets
+// the full page, as in the pipeline. Which one is loaded is settled in the
+// constructor.
+class DocPreprocessor {
+public:
+    DocPreprocessor(const std::string& orientation_model_dir, const std::string& unwarp_model_dir,
+                    const std::string& device, int cpu_threads);
+
+    // Returns the corrected full-resolution page (BGR); either step can be left out
+    // to match a pipeline configured without it. Throws std::runtime_error when the
+    // image cannot be decoded or a model fails.
+    cv::Mat Process(const std::string& image_path, DocPreprocessTiming* timing, bool orientation = true,
+                    bool unwarp = true);
+
+    // doc_ori only, batched over already decoded pages; angles[i] belongs to pages[i]
+    void ClassifyPages(const std::vector<cv::Mat>& pages, std::vector<int>* angles);
+
+    // True when UVDoc returns a backward map, i.e. unwarping runs on the thumbnail
+    bool UnwarpsFromThumbnail() const { return unwarp_channels_ == 2; }
+
+    // Stage tensors of both models shared with pooled buffers (default) or copied
+    void SetZeroCopy(bool enabled) {
+        orientation_.SetZeroCopy(enabled);
+        unwarp_.SetZeroCopy(enabled);
+    }
+
+private:
+    void ClassifyOrientations(const std::vector<cv::Mat>& thumbnails, std::vector<int>* angles);
+    cv::Mat Unwarp(const cv::Mat& page, const cv::Mat& thumbnail, bool* remapped);
+
+    StagePredictor orientation_;
+    StagePredictor unwarp_;
+    int resize_short_ = 256;
+    int crop_size_ = 224;
+    std::vector<int> angles_ = {0, 90, 180, 270};
+    int unwarp_channels_ = 0; // UVDoc output: 2 = backward map, 3 = unwarped image
+};
+
+struct DocPreprocessSummary {
+    int images = 0;
+    int failed = 0;
+    int rotated = 0;
+    int remapped = 0;
+    double decode_ms = 0.0; // sums of per-image averages
+    double orientation_ms = 0.0;
+    double unwarp_ms = 0.0;
+    double ocr_ms = 0.0;
+    double total_ms = 0.0;
+};
+
+// Runs each image `runs` times through `preprocessor` and then `page_ocr`
+// (a pipeline without doc orientation / unwarping) and prints a
+// DOC_PREPROCESS_RESULT line with the stage split next to the full pipeline
+// time from pipeline_ms (keyed by file name). Results are saved as
+// <output_dir><stem>_res.json.
+DocPreprocessSummary runDocPreprocess(const std::vector<std::string>& images,
+                                      DocPreprocessor& preprocessor,
+                                      PaddleOCR& page_ocr,
+                                      int runs,
+                                      const std::map<std::string, double>& pipeline_ms,
+                                      const std::string& output_dir);
@@ -0,0 +1,237 @@
+#include "FusedTextlineRec.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PageStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+// Helper function to warp a quad in one pass to an upright crop `height` pixels
+// high and at most `max_width` wide; tall boxes come out rotated 90 degrees
+// counterclockwise like cropTextRegion
+cv::Mat cropAtHeight(const cv::Mat& image, const std::vector<cv::Point>& quad, int height, int max_width, bool* tall) {
+    *tall = false;
+    if (quad.size() != 4) {
+        cv::Mat crop = cropTextRegion(image, quad);
+        if (crop.empty()) return crop;
+        int width = std::max(1, std::min(max_width, static_cast<int>(std::ceil(height * static_cast<double>(crop.cols) / crop.rows))));
+        cv::resize(crop, crop, cv::Size(width, height));
+        return crop;
+    }
+    cv::Point2f src[4];
+    for (int i = 0; i < 4; i++) src[i] = cv::Point2f(quad[i].x, quad[i].y);
+    float box_width = std::max(pointDistance(src[0], src[1]), pointDistance(src[2], src[3]));
+    float box_height = std::max(pointDistance(src[0], src[3]), pointDistance(src[1], src[2]));
+    if (box_width < 1 || box_height < 1) return cv::Mat();
+
+    if (box_height >= box_width * 1.5f) {
+        // Start from the top-right corner: same result as warping, then rotating counterclockwise
+        *tall = true;
+        cv::Point2f rotated[4] = {src[1], src[2], src[3], src[0]};
+        std::copy(rotated, rotated + 4, src);
+        std::swap(box_width, box_height);
+    }
+    int width = std::max(1, std::min(max_width, static_cast<int>(std::ceil(height * box_width / box_height))));
+    cv::Point2f dst[4] = {cv::Point2f(0, 0), cv::Point2f(width, 0),
+                          cv::Point2f(width, height), cv::Point2f(0, height)};
+    cv::Mat crop;
+    cv::warpPerspective(image, crop, cv::getPerspectiveTransform(src, dst), cv::Size(width, height),
+                        cv::INTER_CUBIC, cv::BORDER_REPLICATE);
+    return crop;
+}
+
+// Helper function to check if a box is wide and close to horizontal, so an
+// upside-down reading would need an upside-down page (which doc_ori handles)
+bool isUprightBox(const std::vector<cv::Point>& quad, bool tall, double max_angle) {
+    if (tall || quad.size() != 4) return false;
+    double angle = std::atan2(quad[1].y - quad[0].y, quad[1].x - quad[0].x) * 180.0 / CV_PI;
+    return std::fabs(angle) <= max_angle;
+}
+
+void toLines(const std::vector<DetectedBox>& boxes, const std::vector<RecognizedText>& texts,
+             std::vector<OcrLine>* lines) {
+    lines->clear();
+    for (size_t i = 0; i < boxes.size(); i++) {
+        OcrLine line;
+        line.poly = boxes[i].quad;
+        line.text = texts[i].text;
+        line.score = texts[i].score;
+        lines->push_back(line);
+    }
+}
+
+void addTiming(const TextlineRecTiming& run, double scale, TextlineRecTiming* total) {
+    total->crop_ms += run.crop_ms * scale;
+    total->orientation_ms += run.orientation_ms * scale;
+    total->rec_ms += run.rec_ms * scale;
+}
+
+}  // namespace
+
+void recognizeSeparate(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextlineClassifier& classifier,
+                       TextRecognizer& recognizer, std::vector<OcrLine>* lines, TextlineRecTiming* timing) {
+    *timing = TextlineRecTiming();
+    timing->crops = static_cast<int>(boxes.size());
+
+    auto crop_start = std::chrono::high_resolution_clock::now();
+    std::vector<cv::Mat> crops;
+    for (const auto& box : boxes) crops.push_back(cropTextRegion(image, box.quad));
+    timing->crop_ms = elapsedMs(crop_start);
+
+    auto orientation_start = std::chrono::high_resolution_clock::now();
+    std::vector<bool> flipped;
+    classifier.Classify(crops, &flipped);
+    for (size_t i = 0; i < crops.size(); i++) {
+        if (!flipped[i] || crops[i].empty()) continue;
+        cv::rotate(crops[i], crops[i], cv::ROTATE_180);
+        timing->flipped++;
+    }
+    timing->checked = static_cast<int>(crops.size());
+    timing->orientation_ms = elapsedMs(orientation_start);
+
+    auto rec_start = std::chrono::high_resolution_clock::now();
+    std::vector<RecognizedText> texts;
+    recognizer.Recognize(crops, &texts);
+    timing->rec_ms = elapsedMs(rec_start);
+    toLines(boxes, texts, lines);
+}
+
+void recognizeFused(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextlineClassifier& classifier,
+                    TextRecognizer& recognizer, const FusedTextlineOptions& options, std::vector<OcrLine>* lines,
+                    TextlineRecTiming* timing) {
+    *timing = TextlineRecTiming();
+    timing->crops = static_cast<int>(boxes.size());
+
+    auto crop_start = std::chrono::high_resolution_clock::now();
+    std::vector<cv::Mat> crops(boxes.size());
+    std::vector<bool> needs_check(boxes.size(), false);
+    for (size_t i = 0; i < boxes.size(); i++) {
+        bool tall = false;
+        crops[i] = cropAtHeight(image, boxes[i].quad, recognizer.InputHeight(), recognizer.MaxInputWidth(), &tall);
+        needs_check[i] = !crops[i].empty() &&
+                         !(options.skip_upright && isUprightBox(boxes[i].quad, tall, options.upright_angle));
+    }
+    timing->crop_ms = elapsedMs(crop_start);
+
+    // Every crop is InputHeight() high, so width alone orders them by aspect ratio
+    std::vector<size_t> order;
+    for (size_t i = 0; i < crops.size(); i++) {
+        if (!crops[i].empty()) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return crops[a].cols < crops[b].cols; });
+
+    std::vector<RecognizedText> texts(boxes.size());
+    const size_t batch_size = static_cast<size_t>(recognizer.BatchSize());
+    for (size_t start = 0; start < order.size(); start += batch_size) {
+        size_t end = std::min(order.size(), start + batch_size);
+
+        auto orientation_start = std::chrono::high_resolution_clock::now();
+        std::vector<size_t> checked;
+        std::vector<cv::Mat> check_crops;
+        for (size_t k = start; k < end; k++) {
+            if (!needs_check[order[k]]) continue;
+            checked.push_back(order[k]);
+            check_crops.push_back(crops[order[k]]);
+        }
+        if (!check_crops.empty()) {
+            std::vector<bool> flipped;
+            classifier.Classify(check_crops, &flipped);
+            for (size_t k = 0; k < checked.size(); k++) {
+                if (!flipped[k]) continue;
+                cv::rotate(crops[checked[k]], crops[checked[k]], cv::ROTATE_180);
+                timing->flipped++;
+            }
+        }
+        timing->checked += static_cast<int>(checked.size());
+        timing->orientation_ms += elapsedMs(orientation_start);
+
+        auto rec_start = std::chrono::high_resolution_clock::now();
+        std::vector<cv::Mat> bucket;
+        for (size_t k = start; k < end; k++) bucket.push_back(crops[order[k]]);
+        std::vector<RecognizedText> bucket_texts;
+        recognizer.Recognize(bucket, &bucket_texts);
+        for (size_t k = start; k < end; k++) texts[order[k]] = bucket_texts[k - start];
+        timing->rec_ms += elapsedMs(rec_start);
+    }
+    toLines(boxes, texts, lines);
+}
+
+FusedTextlineSummary runFusedTextlineBenchmark(const std::vector<std::string>& images,
+                                               TextDetector& detector,
+                                               TextlineClassifier& classifier,
+                                               TextRecognizer& recognizer,
+                                               const DetectorConfig& config,
+                                               const FusedTextlineOptions& options,
+                                               int runs,
+                                               const std::string& output_dir) {
+    FusedTextlineSummary summary;
+    if (runs < 1) runs = 1;
+    const std::string separate_dir = output_dir + "separate/";
+    const std::string fused_dir = output_dir + "fused/";
+    mkdir(output_dir.c_str(), 0755);
+    mkdir(separate_dir.c_str(), 0755);
+    mkdir(fused_dir.c_str(), 0755);
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            DecodedImage decoded;
+            if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image");
+            const cv::Mat& image = decoded.image;
+            std::vector<DetectedBox> boxes;
+            detector.Detect(image, config, &boxes);
+
+            std::vector<OcrLine> separate_lines;
+            std::vector<OcrLine> fused_lines;
+            TextlineRecTiming separate_run, fused_run;
+            TextlineRecTiming separate, fused;
+            for (int run = 0; run < runs; run++) {
+                recognizeSeparate(image, boxes, classifier, recognizer, &separate_lines, &separate_run);
+                recognizeFused(image, boxes, classifier, recognizer, options, &fused_lines, &fused_run);
+                addTiming(separate_run, 1.0 / runs, &separate);
+                addTiming(fused_run, 1.0 / runs, &fused);
+            }
+            saveOcrLines(separate_dir + documentStem(image_path) + "_res.json", image_path, separate_lines);
+            saveOcrLines(fused_dir + documentStem(image_path) + "_res.json", image_path, fused_lines);
+
+            int mismatches = 0;
+            for (size_t i = 0; i < separate_lines.size(); i++) {
+                if (separate_lines[i].text != fused_lines[i].text) mismatches++;
+            }
+
+            summary.images++;
+            summary.text_mismatches += mismatches;
+            addTiming(separate, 1.0, &summary.separate);
+            addTiming(fused, 1.0, &summary.fused);
+            summary.separate.crops += separate_run.crops;
+            summary.separate.checked += separate_run.checked;
+            summary.separate.flipped += separate_run.flipped;
+            summary.fused.crops += fused_run.crops;
+            summary.fused.checked += fused_run.checked;
+            summary.fused.flipped += fused_run.flipped;
+
+            std::cout << "TEXTLINE_RESULT:{\"filename\":\"" << filename
+                      << "\",\"crops\":" << boxes.size()
+                      << ",\"separate_crop_ms\":" << std::fixed << std::setprecision(2) << separate.crop_ms
+                      << ",\"separate_ori_ms\":" << separate.orientation_ms
+                      << ",\"separate_rec_ms\":" << separate.rec_ms
+                      << ",\"fused_crop_ms\":" << fused.crop_ms
+                      << ",\"fused_ori_ms\":" << fused.orientation_ms
+                      << ",\"fused_rec_ms\":" << fused.rec_ms
+                      << ",\"ori_checked\":" << fused_run.checked
+                      << ",\"flipped\":" << fused_run.flipped
+                      << ",\"text_mismatches\":" << mismatches << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Textline orientation benchmark failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
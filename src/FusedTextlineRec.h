@@ -0,0 +1,55 @@
+#pragma once
+
+#include "OcrResultJson.h"
+#include "TextDetector.h"
+#include "TextRecognizer.h"
+#include "TextlineClassifier.h"
+#include <string>
+#include <vector>
+
+struct FusedTextlineOptions {
+    bool skip_upright = false;   // no 180 degree check for wide, near-horizontal boxes
+    double upright_angle = 10.0; // det box tilt (degrees) still treated as horizontal
+};
+
+struct TextlineRecTiming {
+    double crop_ms = 0.0;
+    double orientation_ms = 0.0; // textline_ori preprocessing + model + flips
+    double rec_ms = 0.0;
+    int crops = 0;
+    int checked = 0; // crops that went through textline_ori
+    int flipped = 0;
+};
+
+// Pipeline order: perspective crop per box, textline_ori over all crops
+// (each resized from the full crop), flipped crops rotated, then rec (each
+// resized from the full crop again).
+void recognizeSeparate(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextlineClassifier& classifier,
+                       TextRecognizer& recognizer, std::vector<OcrLine>* lines, TextlineRecTiming* timing);
+
+// Fused: each box is warped once straight to the rec input height, textline_ori
+// reads that crop, and both models run over the same aspect-ratio buckets, so
+// a flip is a 180 degree rotation of the already sized rec input.
+void recognizeFused(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextlineClassifier& classifier,
+                    TextRecognizer& recognizer, const FusedTextlineOptions& options, std::vector<OcrLine>* lines,
+                    TextlineRecTiming* timing);
+
+struct FusedTextlineSummary {
+    int images = 0;
+    int failed = 0;
+    int text_mismatches = 0; // lines where the two paths read different text
+    TextlineRecTiming separate; // sums of per-image averages
+    TextlineRecTiming fused;
+};
+
+// Detects each image once, then times both paths over the same boxes `runs`
+// times and prints a TEXTLINE_RESULT line per image. Results are saved as
+// <output_dir>separate/<stem>_res.json and <output_dir>fused/<stem>_res.json.
+FusedTextlineSummary runFusedTextlineBenchmark(const std::vector<std::string>& images,
+                                               TextDetector& detector,
+                                               TextlineClassifier& classifier,
+                                               TextRecognizer& recognizer,
+                                               const DetectorConfig& config,
+                                               const FusedTextlineOptions& options,
+                                               int runs,
+                                               const std::string& output_dir);
@@ -0,0 +1,160 @@
+#include "ImageDecoder.h"
+#include "BenchmarkUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+bool readFile(const std::string& path, std::vector<uchar>* bytes) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    bytes->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !bytes->empty();
+}
+
+}  // namespace
+
+std::string imageFormat(const std::vector<uchar>& bytes) {
+    if (bytes.size() >= 3 && bytes[0] == 0xFF && bytes[1] == 0xD8 && bytes[2] == 0xFF) return "jpeg";
+    if (bytes.size() >= 8 && bytes[0] == 0x89 && bytes[1] == 'P' && bytes[2] == 'N' && bytes[3] == 'G') return "png";
+    if (bytes.size() >= 2 && bytes[0] == 'B' && bytes[1] == 'M') return "bmp";
+    if (bytes.size() >= 4 && ((bytes[0] == 'I' && bytes[1] == 'I' && bytes[2] == 42 && bytes[3] == 0) ||
+                              (bytes[0] == 'M' && bytes[1] == 'M' && bytes[2] == 0 && bytes[3] == 42))) return "tiff";
+    if (bytes.size() >= 12 && std::equal(bytes.begin(), bytes.begin() + 4, "RIFF") &&
+        std::equal(bytes.begin() + 8, bytes.begin() + 12, "WEBP")) return "webp";
+    return "other";
+}
+
+bool jpegDimensions(const std::vector<uchar>& bytes, int* width, int* height) {
+    size_t pos = 2;
+    while (pos + 9 < bytes.size()) {
+        if (bytes[pos] != 0xFF) return false;
+        uchar marker = bytes[pos + 1];
+        if (marker == 0xFF) {  // fill byte
+            pos++;
+            continue;
+        }
+        size_t length = (static_cast<size_t>(bytes[pos + 2]) << 8) | bytes[pos + 3];
+        // SOF0..SOF15, except DHT (C4), JPG (C8) and DAC (CC)
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            *height = (bytes[pos + 5] << 8) | bytes[pos + 6];
+            *width = (bytes[pos + 7] << 8) | bytes[pos + 8];
+            return *width > 0 && *height > 0;
+        }
+        if (marker == 0xDA || length < 2) return false; // scan data before any frame header
+        pos += 2 + length;
+    }
+    return false;
+}
+
+bool decodeImage(const std::string& path, int target_max_side, DecodedImage* decoded) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uchar> bytes;
+    if (!readFile(path, &bytes)) return false;
+    decoded->format = imageFormat(bytes);
+    decoded->bytes = bytes.size();
+    decoded->reduction = 1;
+
+    int flag = cv::IMREAD_COLOR;
+    int width = 0, height = 0;
+    if (target_max_side > 0 && decoded->format == "jpeg" && jpegDimensions(bytes, &width, &height)) {
+        const int max_side = std::max(width, height);
+        if (max_side >= 8 * target_max_side) {
+            flag = cv::IMREAD_REDUCED_COLOR_8;
+            decoded->reduction = 8;
+        } else if (max_side >= 4 * target_max_side) {
+            flag = cv::IMREAD_REDUCED_COLOR_4;
+            decoded->reduction = 4;
+        } else if (max_side >= 2 * target_max_side) {
+            flag = cv::IMREAD_REDUCED_COLOR_2;
+            decoded->reduction = 2;
+        }
+    }
+    decoded->image = cv::imdecode(bytes, flag);
+    decoded->decode_ms = elapsedMs(start);
+    return !decoded->image.empty();
+}
+
+std::vector<std::string> imageCodecLibraries() {
+    std::vector<std::string> libraries;
+    std::istringstream info(cv::getBuildInformation());
+    std::string line;
+    while (std::getline(info, line)) {
+        size_t first = line.find_first_not_of(' ');
+        if (first == std::string::npos) continue;
+        line = line.substr(first);
+        if (line.compare(0, 5, "JPEG:") == 0 || line.compare(0, 4, "PNG:") == 0 ||
+            line.compare(0, 5, "TIFF:") == 0 || line.compare(0, 5, "WEBP:") == 0) {
+            libraries.push_back(line);
+        }
+    }
+    return libraries;
+}
+
+DecodeSummary runDecodeBenchmark(const std::vector<std::string>& images, int target_max_side, int runs, int workers) {
+    DecodeSummary summary;
+    if (runs < 1) runs = 1;
+    summary.workers = std::max(1, workers);
+
+    for (const auto& path : images) {
+        DecodedImage full;
+        if (!decodeImage(path, 0, &full)) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Cannot decode " << path << std::endl;
+            continue;
+        }
+        DecodeFormatStats& stats = summary.formats[full.format];
+        stats.files++;
+        stats.bytes += full.bytes;
+        stats.pixels += static_cast<double>(full.image.cols) * full.image.rows;
+
+        DecodedImage reduced;
+        for (int run = 0; run < runs; run++) {
+            auto imread_start = std::chrono::high_resolution_clock::now();
+            cv::Mat baseline = cv::imread(path, cv::IMREAD_COLOR);
+            stats.imread_ms += elapsedMs(imread_start) / runs;
+            if (baseline.empty()) break;
+            decodeImage(path, 0, &full);
+            stats.full_ms += full.decode_ms / runs;
+            decodeImage(path, target_max_side, &reduced);
+            stats.reduced_ms += reduced.decode_ms / runs;
+        }
+        stats.reduced_files += reduced.reduction > 1 ? 1 : 0;
+    }
+
+    // Whole set once more, files handed out to a pool of decoders
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> pool;
+    auto parallel_start = std::chrono::high_resolution_clock::now();
+    for (int w = 0; w < summary.workers; w++) {
+        pool.push_back(std::thread([&]() {
+            DecodedImage decoded;
+            for (size_t i = next++; i < images.size(); i = next++) decodeImage(images[i], target_max_side, &decoded);
+        }));
+    }
+    for (auto& worker : pool) worker.join();
+    summary.parallel_wall_ms = elapsedMs(parallel_start);
+
+    for (const auto& entry : summary.formats) {
+        const DecodeFormatStats& stats = entry.second;
+        double megabytes = stats.bytes / 1e6;
+        double megapixels = stats.pixels / 1e6;
+        std::cout << "DECODE_RESULT:{\"format\":\"" << entry.first
+                  << "\",\"files\":" << stats.files
+                  << ",\"mb\":" << std::fixed << std::setprecision(2) << megabytes
+                  << ",\"imread_mb_s\":" << (stats.imread_ms > 0 ? megabytes * 1000.0 / stats.imread_ms : 0.0)
+                  << ",\"decode_mb_s\":" << (stats.full_ms > 0 ? megabytes * 1000.0 / stats.full_ms : 0.0)
+                  << ",\"reduced_mb_s\":" << (stats.reduced_ms > 0 ? megabytes * 1000.0 / stats.reduced_ms : 0.0)
+                  << ",\"imread_mp_s\":" << (stats.imread_ms > 0 ? megapixels * 1000.0 / stats.imread_ms : 0.0)
+                  << ",\"reduced_files\":" << stats.reduced_files << "}" << std::endl;
+    }
+    return summary;
+}
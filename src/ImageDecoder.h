@@ -0,0 +1,54 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+struct DecodedImage {
+    cv::Mat image;       // 8-bit BGR, the layout det preprocessing reads
+    std::string format;  // "jpeg", "png", "bmp", "tiff", "webp" or "other"
+    size_t bytes = 0;    // compressed file size
+    int reduction = 1;   // DCT-domain downscale factor (JPEG only)
+    double decode_ms = 0.0;
+};
+
+// Helper function to name the container format from the file signature
+std::string imageFormat(const std::vector<uchar>& bytes);
+
+// Helper function to read a JPEG's dimensions from its SOF header without decoding
+bool jpegDimensions(const std::vector<uchar>& bytes, int* width, int* height);
+
+// Decode layer: one read of the file, straight to 3-channel BGR (no separate
+// gray / alpha conversion later). When target_max_side > 0 the caller will
+// downscale to that longer side anyway, so JPEGs are decoded at 1/2, 1/4 or
+// 1/8 scale in the DCT domain as far as that stays at or above the target.
+// Other formats always decode at full resolution: PNG has no reduced decode
+// in OpenCV's codecs, so there is no faster path for it here.
+// Returns false when the file cannot be read or decoded.
+bool decodeImage(const std::string& path, int target_max_side, DecodedImage* decoded);
+
+// Helper function to list the codec libraries OpenCV was built with (JPEG / PNG / TIFF / WEBP lines)
+std::vector<std::string> imageCodecLibraries();
+
+struct DecodeFormatStats {
+    int files = 0;
+    size_t bytes = 0;
+    double pixels = 0.0;      // decoded full-resolution pixels
+    double imread_ms = 0.0;   // cv::imread, IMREAD_COLOR
+    double full_ms = 0.0;     // decodeImage at full resolution
+    double reduced_ms = 0.0;  // decodeImage with target_max_side
+    int reduced_files = 0;    // files that got a DCT-domain downscale
+};
+
+struct DecodeSummary {
+    std::map<std::string, DecodeFormatStats> formats;
+    int failed = 0;
+    int workers = 1;
+    double parallel_wall_ms = 0.0; // all files once through decodeImage(target) on `workers` threads
+};
+
+// Decodes every image `runs` times per method, prints a DECODE_RESULT line
+// per format with MB/s (compressed bytes) and MP/s, then times one pass over
+// all files spread across `workers` threads.
+DecodeSummary runDecodeBenchmark(const std::vector<std::string>& images, int target_max_side, int runs, int workers);
@@ -0,0 +1,189 @@
+#include "IncrementalOcr.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PageStream.h"
+#include "RegionOcr.h"
+#include "SpooledPredict.h"
+#include "xxhash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+const int kTileMargin = 8; // context around changed tiles so lines cut by a tile edge stay whole
+
+struct TileCache {
+    int width = 0;
+    int height = 0;
+    int tile_size = 0;
+    double full_ms = 0.0; // Predict time of the last full-page run
+    std::vector<uint64_t> hashes;
+    std::vector<OcrLine> lines;
+};
+
+// Row-major tile hashes; each tile chains XXH64 over its row segments
+std::vector<uint64_t> tileHashes(const cv::Mat& image, int tile_size) {
+    const int tiles_x = (image.cols + tile_size - 1) / tile_size;
+    const int tiles_y = (image.rows + tile_size - 1) / tile_size;
+    const size_t pixel_bytes = image.elemSize();
+    std::vector<uint64_t> hashes(static_cast<size_t>(tiles_x) * tiles_y, 0);
+    for (int ty = 0; ty < tiles_y; ty++) {
+        int y_end = std::min(image.rows, (ty + 1) * tile_size);
+        for (int y = ty * tile_size; y < y_end; y++) {
+            const uchar* row = image.ptr<uchar>(y);
+            for (int tx = 0; tx < tiles_x; tx++) {
+                int x0 = tx * tile_size;
+                int width = std::min(image.cols, x0 + tile_size) - x0;
+                uint64_t& hash = hashes[static_cast<size_t>(ty) * tiles_x + tx];
+                hash = XXH64(row + x0 * pixel_bytes, width * pixel_bytes, hash);
+            }
+        }
+    }
+    return hashes;
+}
+
+bool loadTileCache(const std::string& tiles_path, const std::string& lines_path, TileCache* cache) {
+    std::ifstream in(tiles_path);
+    if (!in) return false;
+    nlohmann::json root = nlohmann::json::parse(in, nullptr, false);
+    if (root.is_discarded() || !root.contains("hashes")) return false;
+    cache->width = root.value("width", 0);
+    cache->height = root.value("height", 0);
+    cache->tile_size = root.value("tile_size", 0);
+    cache->full_ms = root.value("full_ms", 0.0);
+    cache->hashes = root["hashes"].get<std::vector<uint64_t> >();
+    return loadOcrLines(lines_path, &cache->lines);
+}
+
+bool saveTileCache(const std::string& tiles_path, const std::string& lines_path,
+                   const std::string& input_path, const TileCache& cache) {
+    nlohmann::json root;
+    root["width"] = cache.width;
+    root["height"] = cache.height;
+    root["tile_size"] = cache.tile_size;
+    root["full_ms"] = cache.full_ms;
+    root["hashes"] = cache.hashes;
+    std::ofstream out(tiles_path);
+    if (!out) return false;
+    out << root.dump() << std::endl;
+    return static_cast<bool>(out) && saveOcrLines(lines_path, input_path, cache.lines);
+}
+
+}  // namespace
+
+IncrementalOcrSummary runIncrementalOcr(const std::vector<std::string>& images,
+                                        PaddleOCR& infer,
+                                        const IncrementalOcrOptions& options,
+                                        const std::string& output_dir) {
+    IncrementalOcrSummary summary;
+    const int tile_size = std::max(8, options.tile_size);
+    mkdir(output_dir.c_str(), 0755);
+    mkdir(options.cache_dir.c_str(), 0755);
+    const std::string spool_dir = spoolDirectory(output_dir);
+
+    for (const auto& image_path : images) {
+        const std::string stem = documentStem(image_path);
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        const std::string tiles_path = options.cache_dir + stem + "_tiles.json";
+        const std::string cache_lines_path = options.cache_dir + stem + "_res.json";
+        try {
+            DecodedImage decoded;
+            if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image");
+            const cv::Mat& image = decoded.image;
+            const cv::Rect page(0, 0, image.cols, image.rows);
+            const int tiles_x = (image.cols + tile_size - 1) / tile_size;
+
+            auto hash_start = std::chrono::high_resolution_clock::now();
+            std::vector<uint64_t> hashes = tileHashes(image, tile_size);
+            double hash_ms = elapsedMs(hash_start);
+
+            TileCache cache;
+            bool usable = loadTileCache(tiles_path, cache_lines_path, &cache) &&
+                          cache.width == image.cols && cache.height == image.rows &&
+                          cache.tile_size == tile_size && cache.hashes.size() == hashes.size();
+
+            // Changed tiles, padded so neighbours overlap and merge into one region
+            std::vector<cv::Rect> regions;
+            int changed_tiles = static_cast<int>(hashes.size());
+            if (usable) {
+                changed_tiles = 0;
+                for (size_t i = 0; i < hashes.size(); i++) {
+                    if (hashes[i] == cache.hashes[i]) continue;
+                    changed_tiles++;
+                    int tx = static_cast<int>(i % tiles_x);
+                    int ty = static_cast<int>(i / tiles_x);
+                    cv::Rect tile(tx * tile_size - kTileMargin, ty * tile_size - kTileMargin,
+                                  tile_size + 2 * kTileMargin, tile_size + 2 * kTileMargin);
+                    regions.push_back(tile & page);
+                }
+                growRegionsOverLines(&regions, cache.lines, page);
+            }
+            double region_area = 0.0;
+            for (const auto& region : regions) region_area += region.area();
+            bool full = !usable || region_area > options.full_page_ratio * page.area();
+            if (full) regions.assign(1, page);
+
+            std::vector<OcrLine> lines;
+            int reused = full ? 0 : keepLinesOutside(cache.lines, regions, &lines);
+            double inference_ms = ocrRegions(infer, image, regions, spool_dir, stem, &lines);
+            sortLinesReadingOrder(&lines);
+            double ocr_area = full ? page.area() : region_area;
+
+            const char* mode = full ? "full" : (regions.empty() ? "cached" : "partial");
+            double previous_full_ms = usable ? cache.full_ms : 0.0;
+            summary.images++;
+            summary.page_pixels += page.area();
+            summary.ocr_pixels += ocr_area;
+            summary.hash_ms += hash_ms;
+            summary.inference_ms += inference_ms;
+            if (full) {
+                summary.full++;
+            } else if (regions.empty()) {
+                summary.cached++;
+            } else {
+                summary.partial++;
+            }
+            if (!full && previous_full_ms > 0) {
+                summary.cached_full_ms += previous_full_ms;
+                summary.incremental_ms += hash_ms + inference_ms;
+            }
+
+            saveOcrLines(output_dir + stem + "_res.json", image_path, lines);
+            TileCache updated;
+            updated.width = image.cols;
+            updated.height = image.rows;
+            updated.tile_size = tile_size;
+            updated.full_ms = full ? inference_ms : previous_full_ms;
+            updated.hashes.swap(hashes);
+            updated.lines = lines;
+            if (!saveTileCache(tiles_path, cache_lines_path, image_path, updated)) {
+                std::cerr << "  [WARNING] Cannot update tile cache for " << image_path << std::endl;
+            }
+
+            std::cout << "INCREMENTAL_RESULT:{\"filename\":\"" << filename
+                      << "\",\"mode\":\"" << mode
+                      << "\",\"changed_tiles\":" << changed_tiles
+                      << ",\"total_tiles\":" << updated.hashes.size()
+                      << ",\"ocr_area_ratio\":" << std::fixed << std::setprecision(4) << ocr_area / page.area()
+                      << ",\"reused_lines\":" << reused
+                      << ",\"hash_ms\":" << std::setprecision(2) << hash_ms
+                      << ",\"inference_ms\":" << inference_ms;
+            if (previous_full_ms > 0) {
+                std::cout << ",\"cached_full_ms\":" << previous_full_ms;
+            }
+            std::cout << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Incremental OCR failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include <string>
+#include <vector>
+
+struct IncrementalOcrOptions {
+    std::string cache_dir = "./output/cache/"; // tile hashes + line results of the last version of each document
+    int tile_size = 64;                        // pixels per tile side
+    double full_page_ratio = 0.5;              // changed area fraction above which the whole page is re-OCRed
+};
+
+struct IncrementalOcrSummary {
+    int images = 0;
+    int failed = 0;
+    int cached = 0;  // no tile changed, cached result reused as is
+    int partial = 0; // changed tiles re-OCRed
+    int full = 0;    // no usable cache or too much changed
+    double page_pixels = 0.0;
+    double ocr_pixels = 0.0;
+    double hash_ms = 0.0;
+    double inference_ms = 0.0;
+    double cached_full_ms = 0.0; // what the same pages took on their last full run, where known
+    double incremental_ms = 0.0; // hash + inference for those pages in this run
+};
+
+// Diff-aware OCR of re-submitted documents. Each page is split into tiles that
+// are hashed and compared with the hashes cached for the previous version of
+// the same file name; only changed tiles (grown to whole lines) go through the
+// pipeline and the cached lines elsewhere are reused. Results are saved as
+// <output_dir><stem>_res.json, the cache is refreshed, and every page is
+// reported on an INCREMENTAL_RESULT line.
+IncrementalOcrSummary runIncrementalOcr(const std::vector<std::string>& images,
+                                        PaddleOCR& infer,
+                                        const IncrementalOcrOptions& options,
+                                        const std::string& output_dir);
@@ -0,0 +1,113 @@
+#include "JsonSerializerBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "OcrResultJson.h"
+#include "PageStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+const char* const kSharedFields[] = {"input_path", "rec_boxes", "rec_polys", "rec_scores", "rec_texts"};
+
+bool readFile(const std::string& path, std::string* text) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    text->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Helper function to cut the raw text of a top-level value out of a dump(4) document:
+// from after `"key": ` up to the next top-level key or the closing brace
+bool topLevelValue(const std::string& document, const std::string& key, std::string* value) {
+    const std::string marker = "\n    \"" + key + "\": ";
+    size_t start = document.find(marker);
+    if (start == std::string::npos) return false;
+    start += marker.size();
+    size_t next_key = document.find("\n    \"", start);
+    size_t close = document.find("\n}", start);
+    size_t end = std::min(next_key, close);
+    if (end == std::string::npos) return false;
+    if (end > start && document[end - 1] == ',') end--;
+    *value = document.substr(start, end - start);
+    return true;
+}
+
+}  // namespace
+
+JsonSerializerSummary runJsonSerializerBenchmark(const std::vector<std::string>& images,
+                                                 PaddleOCR& ocr,
+                                                 int iterations,
+                                                 const std::string& output_dir) {
+    JsonSerializerSummary summary;
+    if (iterations < 1) iterations = 1;
+    const std::string pipeline_dir = output_dir + "save_to_json/";
+    const std::string stream_dir = output_dir + "stream/";
+    mkdir(output_dir.c_str(), 0755);
+    mkdir(pipeline_dir.c_str(), 0755);
+    mkdir(stream_dir.c_str(), 0755);
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        const std::string pipeline_path = pipeline_dir + documentStem(image_path) + "_res.json";
+        const std::string stream_path = stream_dir + documentStem(image_path) + "_res.json";
+        try {
+            auto outputs = ocr.Predict(image_path);
+
+            auto save_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                for (auto& output : outputs) output->SaveToJson(pipeline_dir);
+            }
+            double save_ms = elapsedMs(save_start) / iterations;
+
+            std::vector<OcrLine> lines;
+            std::string pipeline_text;
+            if (!loadOcrLines(pipeline_path, &lines) || !readFile(pipeline_path, &pipeline_text)) {
+                throw std::runtime_error("cannot read " + pipeline_path);
+            }
+
+            auto stream_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                if (!saveOcrLines(stream_path, image_path, lines)) throw std::runtime_error("cannot write " + stream_path);
+            }
+            double stream_ms = elapsedMs(stream_start) / iterations;
+
+            std::string stream_text;
+            if (!readFile(stream_path, &stream_text)) throw std::runtime_error("cannot read " + stream_path);
+            std::string differing;
+            for (const char* field : kSharedFields) {
+                std::string pipeline_value, stream_value;
+                bool found = topLevelValue(pipeline_text, field, &pipeline_value) &&
+                             topLevelValue(stream_text, field, &stream_value);
+                if (found && pipeline_value == stream_value) continue;
+                differing += std::string(differing.empty() ? "" : ",") + "\"" + field + "\"";
+            }
+
+            summary.documents++;
+            summary.mismatches += differing.empty() ? 0 : 1;
+            summary.save_to_json_bytes += pipeline_text.size();
+            summary.stream_bytes += stream_text.size();
+            summary.save_to_json_ms += save_ms;
+            summary.stream_ms += stream_ms;
+
+            std::cout << "JSON_SERIALIZER_RESULT:{\"filename\":\"" << filename
+                      << "\",\"lines\":" << lines.size()
+                      << ",\"save_to_json_bytes\":" << pipeline_text.size()
+                      << ",\"stream_bytes\":" << stream_text.size()
+                      << ",\"save_to_json_ms\":" << std::fixed << std::setprecision(4) << save_ms
+                      << ",\"stream_ms\":" << stream_ms
+                      << ",\"shared_fields_identical\":" << (differing.empty() ? "true" : "false")
+                      << ",\"differing_fields\":[" << differing << "]}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] JSON serializer benchmark failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
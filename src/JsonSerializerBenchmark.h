@@ -0,0 +1,26 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include <string>
+#include <vector>
+
+struct JsonSerializerSummary {
+    int documents = 0;
+    int failed = 0;
+    int mismatches = 0;            // documents where a shared field differs in any byte
+    size_t save_to_json_bytes = 0; // file sizes of one pass over all documents
+    size_t stream_bytes = 0;
+    double save_to_json_ms = 0.0;  // output->SaveToJson, per pass
+    double stream_ms = 0.0;        // formatOcrLines + write (saveOcrLines), per pass
+};
+
+// Runs each image through `ocr` once (untimed), then writes its result
+// `iterations` times with the pipeline's SaveToJson and with saveOcrLines on
+// the lines read back from that file. The fields both writers produce
+// (input_path, rec_boxes, rec_polys, rec_scores, rec_texts) are compared byte
+// for byte; dt_polys is left out because saveOcrLines only has the rec
+// polygons. Prints a JSON_SERIALIZER_RESULT line per image.
+JsonSerializerSummary runJsonSerializerBenchmark(const std::vector<std::string>& images,
+                                                 PaddleOCR& ocr,
+                                                 int iterations,
+                                                 const std::string& output_dir);
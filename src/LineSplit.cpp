@@ -0,0 +1,232 @@
+#include "LineSplit.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PageStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+// One rec input cut from a line: [start, end) of the resized line, owning [own_start, own_end)
+struct Chunk {
+    size_t line = 0;
+    int start = 0;
+    int end = 0;
+    int own_start = 0;
+    int own_end = 0;
+};
+
+// Helper function to get the ink of each column: distance from the mean brightness, summed over rows
+std::vector<double> columnInk(const cv::Mat& line) {
+    cv::Mat gray = line;
+    if (line.channels() == 3) cv::cvtColor(line, gray, cv::COLOR_BGR2GRAY);
+    const double background = cv::mean(gray)[0];
+    std::vector<double> ink(gray.cols, 0.0);
+    for (int y = 0; y < gray.rows; y++) {
+        const uchar* row = gray.ptr<uchar>(y);
+        for (int x = 0; x < gray.cols; x++) ink[x] += std::fabs(row[x] - background);
+    }
+    return ink;
+}
+
+// Helper function to place the cuts of a line of `width` pixels: about evenly spaced,
+// each moved to the least inked column (3-column window) near its ideal position
+std::vector<int> chooseCuts(const cv::Mat& line, int max_width) {
+    const int width = line.cols;
+    const int count = (width + max_width - 1) / max_width;
+    std::vector<double> ink = columnInk(line);
+    std::vector<int> cuts(1, 0);
+    const int window = std::max(1, width / count / 6);
+    for (int k = 1; k < count; k++) {
+        int ideal = static_cast<int>(static_cast<long long>(width) * k / count);
+        int best = ideal;
+        double best_ink = -1.0;
+        for (int x = std::max(cuts.back() + 1, ideal - window); x <= std::min(width - 2, ideal + window); x++) {
+            double value = ink[x - 1] + ink[x] + ink[x + 1];
+            if (best_ink < 0.0 || value < best_ink) {
+                best_ink = value;
+                best = x;
+            }
+        }
+        cuts.push_back(best);
+    }
+    cuts.push_back(width);
+    return cuts;
+}
+
+// Helper function to append `next` to `text` without repeating their longest suffix/prefix overlap (up to max_chars)
+void appendDeduplicated(std::vector<std::string>* text, const std::vector<std::string>& next, size_t max_chars) {
+    size_t overlap = 0;
+    for (size_t n = std::min(max_chars, std::min(text->size(), next.size())); n > 0; n--) {
+        if (std::equal(text->end() - n, text->end(), next.begin())) {
+            overlap = n;
+            break;
+        }
+    }
+    text->insert(text->end(), next.begin() + overlap, next.end());
+}
+
+void addTiming(const LineSplitTiming& run, double scale, LineSplitTiming* total) {
+    total->crop_ms += run.crop_ms * scale;
+    total->rec_ms += run.rec_ms * scale;
+}
+
+}  // namespace
+
+void recognizeSplit(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextRecognizer& recognizer,
+                    const LineSplitOptions& options, std::vector<OcrLine>* lines, LineSplitTiming* timing) {
+    *timing = LineSplitTiming();
+    const int height = recognizer.InputHeight();
+    const int margin = std::max(1, static_cast<int>(options.overlap * height / 2));
+
+    auto crop_start = std::chrono::high_resolution_clock::now();
+    std::vector<cv::Mat> crops;
+    std::vector<Chunk> chunks;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        cv::Mat crop = cropTextRegion(image, boxes[i].quad);
+        Chunk whole;
+        whole.line = i;
+        int width = crop.empty() ? 0 : static_cast<int>(std::ceil(height * static_cast<double>(crop.cols) / crop.rows));
+        if (options.max_width <= 0 || width <= options.max_width) {
+            crops.push_back(crop);
+            chunks.push_back(whole);
+            continue;
+        }
+
+        cv::Mat resized;
+        cv::resize(crop, resized, cv::Size(width, height));
+        std::vector<int> cuts = chooseCuts(resized, options.max_width);
+        for (size_t k = 0; k + 1 < cuts.size(); k++) {
+            Chunk chunk;
+            chunk.line = i;
+            chunk.own_start = cuts[k];
+            chunk.own_end = cuts[k + 1];
+            chunk.start = std::max(0, cuts[k] - margin);
+            chunk.end = std::min(width, cuts[k + 1] + margin);
+            crops.push_back(resized(cv::Rect(chunk.start, 0, chunk.end - chunk.start, height)));
+            chunks.push_back(chunk);
+        }
+        timing->split_lines++;
+    }
+    timing->crops = static_cast<int>(crops.size());
+    timing->crop_ms = elapsedMs(crop_start);
+
+    auto rec_start = std::chrono::high_resolution_clock::now();
+    std::vector<RecognizedText> texts;
+    recognizer.Recognize(crops, &texts);
+    timing->rec_ms = elapsedMs(rec_start);
+
+    // Chunks of a line are consecutive and left to right
+    lines->assign(boxes.size(), OcrLine());
+    for (size_t i = 0; i < boxes.size(); i++) (*lines)[i].poly = boxes[i].quad;
+    std::vector<std::vector<std::string> > characters(boxes.size());
+    std::vector<double> score_sums(boxes.size(), 0.0);
+    std::vector<int> score_counts(boxes.size(), 0);
+    for (size_t c = 0; c < chunks.size(); c++) {
+        const Chunk& chunk = chunks[c];
+        const RecognizedText& text = texts[c];
+        if (chunk.end == 0) {
+            (*lines)[chunk.line].text = text.text;
+            (*lines)[chunk.line].score = text.score;
+            continue;
+        }
+        std::vector<std::string> chunk_characters = utf8Characters(text.text);
+        if (chunk_characters.size() != text.char_x.size()) {
+            appendDeduplicated(&characters[chunk.line], chunk_characters, static_cast<size_t>(std::max(1.0, options.overlap * 2)));
+            score_sums[chunk.line] += text.score * chunk_characters.size();
+            score_counts[chunk.line] += static_cast<int>(chunk_characters.size());
+            continue;
+        }
+        for (size_t k = 0; k < chunk_characters.size(); k++) {
+            double x = chunk.start + text.char_x[k] * (chunk.end - chunk.start);
+            if (x < chunk.own_start || x >= chunk.own_end) continue;
+            characters[chunk.line].push_back(chunk_characters[k]);
+            score_sums[chunk.line] += text.char_scores[k];
+            score_counts[chunk.line]++;
+        }
+    }
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (score_counts[i] == 0 && characters[i].empty()) continue;
+        std::string joined;
+        for (const auto& character : characters[i]) joined += character;
+        (*lines)[i].text = joined;
+        (*lines)[i].score = score_counts[i] > 0 ? static_cast<float>(score_sums[i] / score_counts[i]) : 0.0f;
+    }
+}
+
+LineSplitSummary runLineSplitBenchmark(const std::vector<std::string>& images,
+                                       TextDetector& detector,
+                                       TextRecognizer& recognizer,
+                                       const DetectorConfig& config,
+                                       const LineSplitOptions& options,
+                                       int runs,
+                                       const std::string& output_dir) {
+    LineSplitSummary summary;
+    if (runs < 1) runs = 1;
+    const std::string whole_dir = output_dir + "whole/";
+    const std::string split_dir = output_dir + "split/";
+    mkdir(output_dir.c_str(), 0755);
+    mkdir(whole_dir.c_str(), 0755);
+    mkdir(split_dir.c_str(), 0755);
+    LineSplitOptions unsplit = options;
+    unsplit.max_width = 0;
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            DecodedImage decoded;
+            if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image");
+            const cv::Mat& image = decoded.image;
+            std::vector<DetectedBox> boxes;
+            detector.Detect(image, config, &boxes);
+
+            std::vector<OcrLine> whole_lines, split_lines;
+            LineSplitTiming whole_run, split_run;
+            LineSplitTiming whole, split;
+            for (int run = 0; run < runs; run++) {
+                recognizeSplit(image, boxes, recognizer, unsplit, &whole_lines, &whole_run);
+                recognizeSplit(image, boxes, recognizer, options, &split_lines, &split_run);
+                addTiming(whole_run, 1.0 / runs, &whole);
+                addTiming(split_run, 1.0 / runs, &split);
+            }
+            saveOcrLines(whole_dir + documentStem(image_path) + "_res.json", image_path, whole_lines);
+            saveOcrLines(split_dir + documentStem(image_path) + "_res.json", image_path, split_lines);
+
+            int mismatches = 0;
+            for (size_t i = 0; i < whole_lines.size(); i++) {
+                if (whole_lines[i].text != split_lines[i].text) mismatches++;
+            }
+
+            summary.images++;
+            summary.text_mismatches += mismatches;
+            addTiming(whole, 1.0, &summary.whole);
+            addTiming(split, 1.0, &summary.split);
+            summary.whole.crops += whole_run.crops;
+            summary.split.crops += split_run.crops;
+            summary.split.split_lines += split_run.split_lines;
+            if (split_run.split_lines > 0) {
+                summary.long_line_pages++;
+                summary.whole_ms.push_back(whole.crop_ms + whole.rec_ms);
+                summary.split_ms.push_back(split.crop_ms + split.rec_ms);
+            }
+
+            std::cout << "LINE_SPLIT_RESULT:{\"filename\":\"" << filename
+                      << "\",\"lines\":" << boxes.size()
+                      << ",\"split_lines\":" << split_run.split_lines
+                      << ",\"crops\":" << split_run.crops
+                      << ",\"whole_ms\":" << std::fixed << std::setprecision(2) << whole.crop_ms + whole.rec_ms
+                      << ",\"split_ms\":" << split.crop_ms + split.rec_ms
+                      << ",\"text_mismatches\":" << mismatches << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Line split benchmark failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
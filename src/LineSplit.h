@@ -0,0 +1,51 @@
+#pragma once
+
+#include "OcrResultJson.h"
+#include "TextDetector.h"
+#include "TextRecognizer.h"
+#include <string>
+#include <vector>
+
+struct LineSplitOptions {
+    int max_width = 960;  // rec input pixels (at the rec height) above which a line is split
+    double overlap = 1.0; // chunk overlap around each cut, in rec heights
+};
+
+struct LineSplitTiming {
+    double crop_ms = 0.0; // crops, resizes and cut search
+    double rec_ms = 0.0;
+    int crops = 0;        // rec inputs
+    int split_lines = 0;  // lines cut into chunks
+};
+
+// Lines wider than max_width at the rec height are cut near evenly spaced
+// points, each cut moved to the column with the least ink within a sixth of
+// a chunk, and recognized as overlapping chunks in the same Recognize call
+// as the other crops, so they share ordinary rec buckets. Every chunk owns
+// the range between its cuts: characters whose CTC step falls in the
+// overlap are kept only by the owning chunk (suffix/prefix matching when
+// step positions are unavailable).
+void recognizeSplit(const cv::Mat& image, const std::vector<DetectedBox>& boxes, TextRecognizer& recognizer,
+                    const LineSplitOptions& options, std::vector<OcrLine>* lines, LineSplitTiming* timing);
+
+struct LineSplitSummary {
+    int images = 0;
+    int failed = 0;
+    int long_line_pages = 0;
+    int text_mismatches = 0;        // lines read differently when split
+    LineSplitTiming whole;          // sums of per-image averages
+    LineSplitTiming split;
+    std::vector<double> whole_ms;   // crop + rec per long-line page
+    std::vector<double> split_ms;
+};
+
+// Detects each image once, then times rec of whole lines and of split lines
+// `runs` times each, and prints a LINE_SPLIT_RESULT line per image. Results
+// are saved as <output_dir>whole/<stem>_res.json and <output_dir>split/<stem>_res.json.
+LineSplitSummary runLineSplitBenchmark(const std::vector<std::string>& images,
+                                       TextDetector& detector,
+                                       TextRecognizer& recognizer,
+                                       const DetectorConfig& config,
+                                       const LineSplitOptions& options,
+                                       int runs,
+                                       const std::string& output_dir);
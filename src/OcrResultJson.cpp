@@ -0,0 +1,214 @@
+#include "OcrResultJson.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+bool loadResultJson(const std::string& res_json_path, nlohmann::json* result) {
+    std::ifstream in(res_json_path);
+    if (!in) return false;
+    *result = nlohmann::json::parse(in, nullptr, false);
+    return !result->is_discarded() && result->contains("rec_texts");
+}
+
+// Bounding box as the rec_boxes entry [x0, y0, x1, y1] (width / height hold x1 - x0, y1 - y0)
+cv::Rect polyBounds(const std::vector<cv::Point>& poly) {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    for (size_t i = 0; i < poly.size(); i++) {
+        const cv::Point& p = poly[i];
+        x0 = i == 0 ? p.x : std::min(x0, p.x);
+        y0 = i == 0 ? p.y : std::min(y0, p.y);
+        x1 = i == 0 ? p.x : std::max(x1, p.x);
+        y1 = i == 0 ? p.y : std::max(y1, p.y);
+    }
+    return cv::Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+// Appends values the way nlohmann::json::dump(4) prints them, straight into a string
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string* out) : out_(out) {}
+
+    // depth 1 is an array that is the value of a top-level key
+    void BeginArray(bool empty) { out_->append(empty ? "[" : "[\n"); }
+    void Element(int depth, bool first) {
+        if (!first) out_->append(",\n");
+        out_->append(static_cast<size_t>(4 * (depth + 1)), ' ');
+    }
+    void EndArray(int depth, bool empty) {
+        if (!empty) {
+            out_->push_back('\n');
+            out_->append(static_cast<size_t>(4 * depth), ' ');
+        }
+        out_->push_back(']');
+    }
+
+    void Int(int value) {
+        char digits[12];
+        unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+        int length = 0;
+        do {
+            digits[length++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) out_->push_back('-');
+        while (length > 0) out_->push_back(digits[--length]);
+    }
+
+    // Formatted by dump() on the leaf value alone (public API, no document tree), so scores
+    // carry dump()'s digits exactly; a plain shortest-%g loop disagrees on some floats
+    void Double(double value) {
+        if (!std::isfinite(value)) {
+            out_->append("null");
+            return;
+        }
+        out_->append(nlohmann::json(value).dump());
+    }
+
+    void String(const std::string& value) {
+        static const char kHex[] = "0123456789abcdef";
+        out_->push_back('"');
+        for (unsigned char c : value) {
+            switch (c) {
+                case '"': out_->append("\\\""); break;
+                case '\\': out_->append("\\\\"); break;
+                case '\b': out_->append("\\b"); break;
+                case '\f': out_->append("\\f"); break;
+                case '\n': out_->append("\\n"); break;
+                case '\r': out_->append("\\r"); break;
+                case '\t': out_->append("\\t"); break;
+                default:
+                    if (c < 0x20) {
+                        out_->append("\\u00");
+                        out_->push_back(kHex[c >> 4]);
+                        out_->push_back(kHex[c & 0xF]);
+                    } else {
+                        out_->push_back(static_cast<char>(c));
+                    }
+            }
+        }
+        out_->push_back('"');
+    }
+
+private:
+    std::string* out_;
+};
+
+void writePolys(const std::vector<OcrLine>& lines, JsonWriter* writer) {
+    writer->BeginArray(lines.empty());
+    for (size_t i = 0; i < lines.size(); i++) {
+        const std::vector<cv::Point>& poly = lines[i].poly;
+        writer->Element(1, i == 0);
+        writer->BeginArray(poly.empty());
+        for (size_t k = 0; k < poly.size(); k++) {
+            writer->Element(2, k == 0);
+            writer->BeginArray(false);
+            writer->Element(3, true);
+            writer->Int(poly[k].x);
+            writer->Element(3, false);
+            writer->Int(poly[k].y);
+            writer->EndArray(3, false);
+        }
+        writer->EndArray(2, poly.empty());
+    }
+    writer->EndArray(1, lines.empty());
+}
+
+}  // namespace
+
+bool loadRecognizedTexts(const std::string& res_json_path, std::vector<std::string>* texts) {
+    nlohmann::json result;
+    if (!loadResultJson(res_json_path, &result)) return false;
+    for (const auto& text : result["rec_texts"]) {
+        texts->push_back(text.get<std::string>());
+    }
+    return true;
+}
+
+bool loadOcrLines(const std::string& res_json_path, std::vector<OcrLine>* lines) {
+    nlohmann::json result;
+    if (!loadResultJson(res_json_path, &result)) return false;
+    const auto& texts = result["rec_texts"];
+    const nlohmann::json empty = nlohmann::json::array();
+    const auto& scores = result.contains("rec_scores") ? result["rec_scores"] : empty;
+    const auto& polys = result.contains("rec_polys") ? result["rec_polys"] : empty;
+    for (size_t i = 0; i < texts.size(); i++) {
+        OcrLine line;
+        line.text = texts[i].get<std::string>();
+        if (i < scores.size()) line.score = scores[i].get<float>();
+        if (i < polys.size()) {
+            for (const auto& point : polys[i]) {
+                line.poly.push_back(cv::Point(point[0].get<int>(), point[1].get<int>()));
+            }
+        }
+        lines->push_back(line);
+    }
+    return true;
+}
+
+void formatOcrLines(const std::string& input_path, const std::vector<OcrLine>& lines, std::string* out) {
+    // nlohmann::json::dump(4) layout: keys in std::map order, 4-space indent, one value per line
+    out->clear();
+    JsonWriter writer(out);
+    out->append("{\n    \"dt_polys\": ");
+    writePolys(lines, &writer);
+    out->append(",\n    \"input_path\": ");
+    writer.String(input_path);
+    out->append(",\n    \"rec_boxes\": ");
+    writer.BeginArray(lines.empty());
+    for (size_t i = 0; i < lines.size(); i++) {
+        cv::Rect box = polyBounds(lines[i].poly);
+        const int coords[4] = {box.x, box.y, box.x + box.width, box.y + box.height};
+        writer.Element(1, i == 0);
+        writer.BeginArray(false);
+        for (int k = 0; k < 4; k++) {
+            writer.Element(2, k == 0);
+            writer.Int(coords[k]);
+        }
+        writer.EndArray(2, false);
+    }
+    writer.EndArray(1, lines.empty());
+    out->append(",\n    \"rec_polys\": ");
+    writePolys(lines, &writer);
+    out->append(",\n    \"rec_scores\": ");
+    writer.BeginArray(lines.empty());
+    for (size_t i = 0; i < lines.size(); i++) {
+        writer.Element(1, i == 0);
+        writer.Double(lines[i].score);
+    }
+    writer.EndArray(1, lines.empty());
+    out->append(",\n    \"rec_texts\": ");
+    writer.BeginArray(lines.empty());
+    for (size_t i = 0; i < lines.size(); i++) {
+        writer.Element(1, i == 0);
+        writer.String(lines[i].text);
+    }
+    writer.EndArray(1, lines.empty());
+    out->append("\n}");
+}
+
+bool saveOcrLines(const std::string& res_json_path, const std::string& input_path,
+                  const std::vector<OcrLine>& lines) {
+    // One buffer per thread, reused across pages
+    static thread_local std::string buffer;
+    formatOcrLines(input_path, lines, &buffer);
+    buffer.push_back('\n');
+
+    std::FILE* file = std::fopen(res_json_path.c_str(), "wb");
+    if (file == nullptr) return false;
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+int countUtf8CodePoints(const std::string& text) {
+    int count = 0;
+    for (unsigned char c : text) {
+        // Continuation bytes look like 10xxxxxx
+        if ((c & 0xC0) != 0x80) count++;
+    }
+    return count;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// One recognized line as stored in <stem>_res.json (rec_polys / rec_texts / rec_scores)
+struct OcrLine {
+    std::vector<cv::Point> poly;
+    std::string text;
+    float score = 0.0f;
+};
+
+// Helper function to read rec_texts from a saved <stem>_res.json
+bool loadRecognizedTexts(const std::string& res_json_path, std::vector<std::string>* texts);
+
+// Helper function to read recognized lines (polygon, text, score) from a saved <stem>_res.json
+bool loadOcrLines(const std::string& res_json_path, std::vector<OcrLine>* lines);
+
+// Helper function to write lines in the <stem>_res.json layout read by calculate_acc.py
+bool saveOcrLines(const std::string& res_json_path, const std::string& input_path,
+                  const std::vector<OcrLine>& lines);
+
+// Helper function to format lines in the <stem>_res.json layout into `out` without a
+// JSON DOM (integers and strings written directly, buffer reusable across calls), laid
+// out as nlohmann::json::dump(4) would. This is the writer for results this repo
+// assembles itself; pipeline results still come from PaddleOCR's SaveToJson, which
+// writes more fields (--json_bench times both and byte-compares the shared ones).
+// No trailing newline (saveOcrLines adds one).
+void formatOcrLines(const std::string& input_path, const std::vector<OcrLine>& lines, std::string* out);
+
+// Helper function to count Unicode code points in a UTF-8 string
+int countUtf8CodePoints(const std::string& text);
@@ -0,0 +1,116 @@
+#include "PaddleStage.h"
+#include "BenchmarkUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+std::atomic<unsigned long long> g_copied_bytes(0);
+std::atomic<unsigned long long> g_shared_bytes(0);
+
+size_t elementCount(const std::vector<int>& shape) {
+    size_t count = 1;
+    for (int dim : shape) count *= static_cast<size_t>(std::max(dim, 0));
+    return count;
+}
+
+}  // namespace
+
+std::shared_ptr<paddle_infer::Predictor> createStagePredictor(const std::string& model_dir,
+                                                              const std::string& device,
+                                                              int cpu_threads) {
+    paddle_infer::Config config;
+    const std::string params_file = model_dir + "/inference.pdiparams";
+    if (isFile(model_dir + "/inference.json")) {
+        // PaddleOCR 3.x exports PIR programs
+        config.SetModel(model_dir + "/inference.json", params_file);
+        config.EnableNewIR(true);
+        config.EnableNewExecutor(true);
+    } else if (isFile(model_dir + "/inference.pdmodel")) {
+        config.SetModel(model_dir + "/inference.pdmodel", params_file);
+    } else {
+        throw std::runtime_error("no inference.json / inference.pdmodel in " + model_dir);
+    }
+
+    if (device.compare(0, 3, "gpu") == 0) {
+        int device_id = device.size() > 4 ? std::atoi(device.c_str() + 4) : 0;
+        config.EnableUseGpu(256, device_id);
+    } else {
+        config.DisableGpu();
+        config.EnableMKLDNN();
+        config.SetCpuMathLibraryNumThreads(cpu_threads > 0 ? cpu_threads : 1);
+    }
+    config.SwitchIrOptim(true);
+    config.EnableMemoryOptim(true);
+    config.DisableGlogInfo();
+    return paddle_infer::CreatePredictor(config);
+}
+
+YAML::Node loadStageConfig(const std::string& model_dir) {
+    const std::string path = model_dir + "/inference.yml";
+    if (!isFile(path)) {
+        throw std::runtime_error("missing " + path);
+    }
+    return YAML::LoadFile(path);
+}
+
+StageCopyCounters stageCopyCounters() {
+    StageCopyCounters counters;
+    counters.copied_bytes = g_copied_bytes;
+    counters.shared_bytes = g_shared_bytes;
+    return counters;
+}
+
+StagePredictor::StagePredictor(const std::string& model_dir, const std::string& device, int cpu_threads)
+    : predictor_(createStagePredictor(model_dir, device, cpu_threads)), host_(device.compare(0, 3, "gpu") != 0) {}
+
+float* StagePredictor::Input(const std::vector<int>& shape, bool zero_fill) {
+    const size_t count = elementCount(shape);
+    if (input_.size() < count) input_.resize(count); // grows to the largest batch seen, never shrinks
+    if (zero_fill) std::fill(input_.begin(), input_.begin() + count, 0.0f);
+    input_shape_ = shape;
+    return input_.data();
+}
+
+bool StagePredictor::Run() {
+    auto input_tensor = predictor_->GetInputHandle(predictor_->GetInputNames()[0]);
+    const unsigned long long bytes = elementCount(input_shape_) * sizeof(float);
+    if (host_ && zero_copy_) {
+        input_tensor->ShareExternalData(input_.data(), input_shape_, paddle_infer::PlaceType::kCPU);
+        g_shared_bytes += bytes;
+    } else {
+        input_tensor->Reshape(input_shape_);
+        input_tensor->CopyFromCpu(input_.data());
+        g_copied_bytes += bytes;
+    }
+    return predictor_->Run();
+}
+
+const float* StagePredictor::Output(std::vector<int>* shape) {
+    auto output_tensor = predictor_->GetOutputHandle(predictor_->GetOutputNames()[0]);
+    *shape = output_tensor->shape();
+    const size_t count = elementCount(*shape);
+    if (host_ && zero_copy_) {
+        paddle_infer::PlaceType place = paddle_infer::PlaceType::kUNK;
+        int size = 0;
+        const float* data = output_tensor->data<float>(&place, &size);
+        if (data != nullptr && place == paddle_infer::PlaceType::kCPU) {
+            g_shared_bytes += count * sizeof(float);
+            return data;
+        }
+    }
+    if (output_.size() < count) output_.resize(count);
+    output_tensor->CopyToCpu(output_.data());
+    g_copied_bytes += count * sizeof(float);
+    return output_.data();
+}
+
+std::vector<int64_t> StagePredictor::DeclaredOutputShape() const {
+    std::map<std::string, std::vector<int64_t> > shapes = predictor_->GetOutputTensorShape();
+    std::map<std::string, std::vector<int64_t> >::const_iterator it = shapes.find(predictor_->GetOutputNames()[0]);
+    return it != shapes.end() ? it->second : std::vector<int64_t>();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "paddle_inference_api.h"
+#include <yaml-cpp/yaml.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Direct Paddle Inference access to single pipeline models, for modes that need to
+// drive det/rec themselves instead of going through PaddleOCR::Predict. Model
+// directories use the PaddleOCR 3.x export layout: inference.json (or the older
+// inference.pdmodel) + inference.pdiparams + inference.yml.
+
+// Helper function to create a predictor for one exported model directory.
+// device is "gpu", "gpu:N" or "cpu". Throws std::runtime_error when the model is missing.
+std::shared_ptr<paddle_infer::Predictor> createStagePredictor(const std::string& model_dir,
+                                                              const std::string& device,
+                                                              int cpu_threads);
+
+// Helper function to load <model_dir>/inference.yml (pre/post-processing settings)
+YAML::Node loadStageConfig(const std::string& model_dir);
+
+// Host <-> tensor traffic of all stage predictors since the program started
+struct StageCopyCounters {
+    unsigned long long copied_bytes = 0; // CopyFromCpu / CopyToCpu
+    unsigned long long shared_bytes = 0; // bound with ShareExternalData or read in place
+};
+
+StageCopyCounters stageCopyCounters();
+
+// One stage model with pooled host buffers bound to its first input and
+// output. Preprocessing writes straight into Input(); on CPU predictors that
+// buffer is bound with ShareExternalData and Output() points into the output
+// tensor, so nothing is copied either way. GPU predictors (and
+// SetZeroCopy(false)) copy through the same buffers instead.
+class StagePredictor {
+public:
+    StagePredictor() {}
+    StagePredictor(const std::string& model_dir, const std::string& device, int cpu_threads);
+
+    // NCHW input buffer for `shape`, reused across runs; zero_fill clears it (padding)
+    float* Input(const std::vector<int>& shape, bool zero_fill = false);
+
+    // Binds the input filled since the last Input() call and runs the model
+    bool Run();
+
+    // First output after Run(); valid until the next Run()
+    const float* Output(std::vector<int>* shape);
+
+    // Shape of the first output as declared by the model, before any run
+    // (-1 for dimensions that depend on the input)
+    std::vector<int64_t> DeclaredOutputShape() const;
+
+    // Switches this predictor between shared pooled buffers (default) and the
+    // CopyFromCpu / CopyToCpu path, e.g. for before/after runs
+    void SetZeroCopy(bool enabled) { zero_copy_ = enabled; }
+
+private:
+    std::shared_ptr<paddle_infer::Predictor> predictor_;
+    bool host_ = true;
+    bool zero_copy_ = true;
+    std::vector<float> input_;
+    std::vector<int> input_shape_;
+    std::vector<float> output_; // only used when the output has to be copied
+};
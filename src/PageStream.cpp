@@ -0,0 +1,129 @@
+#include "PageStream.h"
+#include "BenchmarkUtils.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// cv::ImageCollection (lazy multi-page decoding) is available from OpenCV 4.7
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 7)
+#define PAGE_STREAM_HAVE_IMAGE_COLLECTION 1
+#endif
+
+namespace {
+
+std::string sequenceFrameName(const std::string& pattern, int index) {
+    std::vector<char> buffer(pattern.size() + 32);
+    std::snprintf(buffer.data(), buffer.size(), pattern.c_str(), index);
+    return std::string(buffer.data());
+}
+
+bool isTiffFile(const std::string& path) {
+    size_t dot_pos = path.find_last_of('.');
+    if (dot_pos == std::string::npos) return false;
+    std::string ext = path.substr(dot_pos);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".tif" || ext == ".tiff";
+}
+
+}  // namespace
+
+bool isImageSequencePattern(const std::string& path) {
+    size_t pct = path.find('%');
+    if (pct == std::string::npos) return false;
+    // Only a single integer conversion is accepted ("%d", "%04d", ...)
+    size_t conv = path.find_first_not_of("0123456789", pct + 1);
+    if (conv == std::string::npos || path[conv] != 'd') return false;
+    if (path.find('%', conv) != std::string::npos) return false;
+    return isImageFile(path);
+}
+
+bool isMultiPageDocument(const std::string& path) {
+    if (isImageSequencePattern(path)) return true;
+    if (!isTiffFile(path) || !isFile(path)) return false;
+    return cv::imcount(path, cv::IMREAD_COLOR) > 1;
+}
+
+std::string documentStem(const std::string& path) {
+    std::string stem = path;
+    size_t slash_pos = stem.find_last_of('/');
+    if (slash_pos != std::string::npos) stem = stem.substr(slash_pos + 1);
+    size_t dot_pos = stem.find_last_of('.');
+    if (dot_pos != std::string::npos) stem = stem.substr(0, dot_pos);
+    // "page_%04d" -> "page"
+    size_t pct = stem.find('%');
+    if (pct != std::string::npos) {
+        stem = stem.substr(0, pct);
+        while (!stem.empty() && (stem.back() == '_' || stem.back() == '-')) stem.pop_back();
+        if (stem.empty()) stem = "sequence";
+    }
+    return stem;
+}
+
+struct PageStream::Impl {
+    std::string path;
+    bool sequence = false;
+    bool open = false;
+    int page_count = -1;
+    int next_index = 0;
+    int sequence_offset = 0;  // first frame number of an image sequence (0 or 1)
+#ifdef PAGE_STREAM_HAVE_IMAGE_COLLECTION
+    cv::ImageCollection collection;
+#endif
+};
+
+PageStream::PageStream(const std::string& path) : impl_(new Impl) {
+    impl_->path = path;
+    impl_->sequence = isImageSequencePattern(path);
+    if (impl_->sequence) {
+        // Sequences commonly start at 0 or 1
+        for (int first = 0; first <= 1 && !impl_->open; first++) {
+            if (isFile(sequenceFrameName(path, first))) {
+                impl_->sequence_offset = first;
+                impl_->open = true;
+            }
+        }
+        return;
+    }
+
+    if (!isFile(path)) return;
+    impl_->page_count = static_cast<int>(cv::imcount(path, cv::IMREAD_COLOR));
+#ifdef PAGE_STREAM_HAVE_IMAGE_COLLECTION
+    impl_->collection.init(path, cv::IMREAD_COLOR);
+#endif
+    impl_->open = impl_->page_count > 0;
+}
+
+PageStream::~PageStream() = default;
+
+bool PageStream::IsOpen() const { return impl_->open; }
+
+int PageStream::PageCount() const { return impl_->page_count; }
+
+bool PageStream::Next(cv::Mat* page, int* page_index) {
+    if (!impl_->open) return false;
+    int index = impl_->next_index;
+
+    if (impl_->sequence) {
+        std::string frame = sequenceFrameName(impl_->path, index + impl_->sequence_offset);
+        if (!isFile(frame)) return false;
+        *page = cv::imread(frame, cv::IMREAD_COLOR);
+    } else {
+        if (index >= impl_->page_count) return false;
+#ifdef PAGE_STREAM_HAVE_IMAGE_COLLECTION
+        // The collection keeps its decoder positioned, so sequential access does not
+        // re-walk the TIFF directory; the caller takes over the page buffer and the
+        // collection drops its cached reference
+        *page = impl_->collection.at(index);
+        impl_->collection.releaseCache(index);
+#else
+        std::vector<cv::Mat> pages;
+        cv::imreadmulti(impl_->path, pages, index, 1, cv::IMREAD_COLOR);
+        if (!pages.empty()) *page = pages[0];
+#endif
+    }
+
+    if (page->empty()) return false;
+    *page_index = index;
+    impl_->next_index++;
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+
+// Helper function to check if path is a printf-style image sequence ("scans/page_%04d.png")
+bool isImageSequencePattern(const std::string& path);
+
+// Helper function to check if path holds more than one page (multi-page TIFF or image sequence)
+bool isMultiPageDocument(const std::string& path);
+
+// Helper function to get the base name used for per-page outputs ("scan.tiff" -> "scan")
+std::string documentStem(const std::string& path);
+
+// Lazily decoded pages of a multi-page TIFF or an image sequence. Pages are
+// decoded one at a time on Next(); nothing but the current page is kept, so
+// memory stays bounded by a single page regardless of document length.
+class PageStream {
+public:
+    explicit PageStream(const std::string& path);
+    ~PageStream();
+
+    bool IsOpen() const;
+
+    // Number of pages, or -1 when only known at the end (image sequences)
+    int PageCount() const;
+
+    // Decodes the next page; returns false at the end of the document
+    bool Next(cv::Mat* page, int* page_index);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
@@ -0,0 +1,145 @@
+#include "PageStreaming.h"
+#include "BoundedQueue.h"
+#include "PageStream.h"
+#include "SpooledPredict.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+struct PageTask {
+    std::string document;
+    std::string stem;
+    int page_index = 0;
+    cv::Mat page;
+};
+
+// Closes the queue however the decoder thread leaves, so workers never wait on it forever
+struct CloseOnExit {
+    BoundedQueue<PageTask>& queue;
+    ~CloseOnExit() { queue.Close(); }
+};
+
+std::string pageName(const std::string& stem, int page_index) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_page%04d", page_index + 1);
+    return stem + suffix;
+}
+
+}  // namespace
+
+PageStreamingSummary runPageStreaming(const std::vector<std::string>& documents,
+                                      PaddleOCR& infer,
+                                      const PaddleOCRParams& params,
+                                      int workers,
+                                      const std::string& output_dir) {
+    PageStreamingSummary summary;
+    summary.documents = static_cast<int>(documents.size());
+    if (workers < 1) workers = 1;
+
+    // One page per worker in flight plus one decoded ahead each
+    BoundedQueue<PageTask> queue(static_cast<size_t>(workers));
+    std::mutex report_mutex;
+    const std::string spool_dir = spoolDirectory(output_dir);
+    auto wall_start = std::chrono::high_resolution_clock::now();
+
+    std::thread decoder([&]() {
+        CloseOnExit close_queue{queue};
+        for (const auto& document : documents) {
+            try {
+                PageStream stream(document);
+                if (!stream.IsOpen()) {
+                    std::lock_guard<std::mutex> lock(report_mutex);
+                    std::cerr << "  [ERROR] Cannot open multi-page input: " << document << std::endl;
+                    summary.failed_documents++;
+                    continue;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(report_mutex);
+                    std::cout << "  [PAGES] Streaming " << document;
+                    if (stream.PageCount() > 0) std::cout << " (" << stream.PageCount() << " pages)";
+                    std::cout << std::endl;
+                }
+                PageTask task;
+                while (stream.Next(&task.page, &task.page_index)) {
+                    task.document = document;
+                    task.stem = documentStem(document);
+                    if (!queue.Push(std::move(task))) return;
+                    task = PageTask();
+                }
+            } catch (const std::exception& e) {
+                // A corrupt page ends its document; pages already queued are still processed
+                std::lock_guard<std::mutex> lock(report_mutex);
+                std::cerr << "  [ERROR] Decoding " << document << " failed: " << e.what() << std::endl;
+                summary.failed_documents++;
+            }
+        }
+    });
+
+    auto worker_loop = [&](int worker_id) {
+        std::unique_ptr<PaddleOCR> own_infer;
+        PaddleOCR* ocr = &infer;
+        if (worker_id > 0) {
+            try {
+                own_infer.reset(new PaddleOCR(params));
+            } catch (const std::exception& e) {
+                // Worker 0 always runs, so the remaining workers still drain the queue
+                std::lock_guard<std::mutex> lock(report_mutex);
+                std::cerr << "  [ERROR] Page worker " << worker_id << " failed to initialize: " << e.what() << std::endl;
+                return;
+            }
+            ocr = own_infer.get();
+        }
+
+        PageTask task;
+        while (queue.Pop(&task)) {
+            std::string name = pageName(task.stem, task.page_index);
+            bool ok = false;
+            double inference_ms = 0.0;
+            int chars = 0;
+            try {
+                std::vector<OcrLine> lines;
+                predictSpooledImage(*ocr, task.page, spool_dir, name, &lines, &inference_ms, output_dir);
+                task.page.release();
+                for (const auto& line : lines) chars += countUtf8CodePoints(line.text);
+                ok = true;
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(report_mutex);
+                std::cerr << "  [ERROR] Page " << (task.page_index + 1) << " of " << task.document
+                          << " failed: " << e.what() << std::endl;
+            }
+
+            std::lock_guard<std::mutex> lock(report_mutex);
+            if (!ok) {
+                summary.failed_pages++;
+                continue;
+            }
+            summary.pages++;
+            summary.inference_ms += inference_ms;
+            std::cout << "PER_PAGE_RESULT:{\"document\":\"" << task.document
+                      << "\",\"page\":" << (task.page_index + 1)
+                      << ",\"worker\":" << worker_id
+                      << ",\"inference_ms\":" << std::fixed << std::setprecision(2) << inference_ms
+                      << ",\"total_chars\":" << chars << "}" << std::endl;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < workers; w++) {
+        pool.emplace_back(worker_loop, w);
+    }
+    worker_loop(0);
+    for (auto& t : pool) t.join();
+    decoder.join();
+
+    auto wall_end = std::chrono::high_resolution_clock::now();
+    summary.wall_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count() / 1e6;
+    summary.queue_high_water = queue.HighWater();
+    return summary;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct PageStreamingSummary {
+    int documents = 0;
+    int pages = 0;
+    int failed_pages = 0;
+    int failed_documents = 0;    // could not be opened, or a page failed to decode
+    double wall_ms = 0.0;
+    double inference_ms = 0.0;   // summed over pages (exceeds wall time with several workers)
+    size_t queue_high_water = 0; // decoded pages waiting at most, bounds memory
+};
+
+// Per-page OCR of multi-page TIFFs and image sequences. One decoder thread
+// decodes pages lazily into a bounded queue; `workers` PaddleOCR instances
+// (the given one plus workers-1 built from params) take pages from it. Every
+// page is saved as <stem>_page<NNNN>_res.json and reported on a
+// PER_PAGE_RESULT line.
+PageStreamingSummary runPageStreaming(const std::vector<std::string>& documents,
+                                      PaddleOCR& infer,
+                                      const PaddleOCRParams& params,
+                                      int workers,
+                                      const std::string& output_dir);
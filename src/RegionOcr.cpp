@@ -0,0 +1,89 @@
+#include "RegionOcr.h"
+#include "SpooledPredict.h"
+
+#include <algorithm>
+
+cv::Rect lineBounds(const OcrLine& line) {
+    return line.poly.empty() ? cv::Rect() : cv::boundingRect(line.poly);
+}
+
+void mergeOverlappingRects(std::vector<cv::Rect>* rects) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < rects->size() && !merged; i++) {
+            for (size_t j = i + 1; j < rects->size(); j++) {
+                if (((*rects)[i] & (*rects)[j]).area() > 0) {
+                    (*rects)[i] |= (*rects)[j];
+                    rects->erase(rects->begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void growRegionsOverLines(std::vector<cv::Rect>* regions, const std::vector<OcrLine>& lines, const cv::Rect& limits) {
+    mergeOverlappingRects(regions);
+    bool grown = true;
+    while (grown) {
+        grown = false;
+        for (auto& region : *regions) {
+            for (const auto& line : lines) {
+                cv::Rect bounds = lineBounds(line) & limits;
+                if ((bounds & region).area() > 0 && (bounds | region) != region) {
+                    region |= bounds;
+                    grown = true;
+                }
+            }
+        }
+        if (grown) mergeOverlappingRects(regions);
+    }
+}
+
+int keepLinesOutside(const std::vector<OcrLine>& lines, const std::vector<cv::Rect>& regions, std::vector<OcrLine>* kept) {
+    int count = 0;
+    for (const auto& line : lines) {
+        cv::Rect bounds = lineBounds(line);
+        bool touched = false;
+        for (const auto& region : regions) {
+            if ((bounds & region).area() > 0) {
+                touched = true;
+                break;
+            }
+        }
+        if (!touched) {
+            kept->push_back(line);
+            count++;
+        }
+    }
+    return count;
+}
+
+double ocrRegions(PaddleOCR& ocr, const cv::Mat& image, const std::vector<cv::Rect>& regions,
+                  const std::string& spool_dir, const std::string& name, std::vector<OcrLine>* lines) {
+    double inference_ms = 0.0;
+    for (size_t r = 0; r < regions.size(); r++) {
+        const cv::Rect& region = regions[r];
+        bool whole = region.x == 0 && region.y == 0 && region.width == image.cols && region.height == image.rows;
+        std::vector<OcrLine> region_lines;
+        double region_ms = 0.0;
+        predictSpooledImage(ocr, whole ? image : image(region).clone(), spool_dir,
+                            name + "_region" + std::to_string(r), &region_lines, &region_ms);
+        inference_ms += region_ms;
+        for (auto& line : region_lines) {
+            for (auto& point : line.poly) point = point + region.tl();
+            lines->push_back(line);
+        }
+    }
+    return inference_ms;
+}
+
+void sortLinesReadingOrder(std::vector<OcrLine>* lines) {
+    std::sort(lines->begin(), lines->end(), [](const OcrLine& a, const OcrLine& b) {
+        cv::Rect ra = lineBounds(a);
+        cv::Rect rb = lineBounds(b);
+        return ra.y != rb.y ? ra.y < rb.y : ra.x < rb.x;
+    });
+}
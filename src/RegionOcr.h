@@ -0,0 +1,32 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include "OcrResultJson.h"
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// Partial re-OCR against a previous result: only changed regions go through the
+// pipeline, lines outside them are carried over. Used by the video and
+// incremental document modes.
+
+// Helper function to get the axis-aligned bounds of a line polygon
+cv::Rect lineBounds(const OcrLine& line);
+
+// Helper function to merge overlapping rectangles until none overlap
+void mergeOverlappingRects(std::vector<cv::Rect>* rects);
+
+// Helper function to grow regions over every previous line they touch, so each
+// line is either reused whole or re-recognized whole. Regions stay inside `limits`.
+void growRegionsOverLines(std::vector<cv::Rect>* regions, const std::vector<OcrLine>& lines, const cv::Rect& limits);
+
+// Helper function to copy the lines lying outside all regions; returns how many were kept
+int keepLinesOutside(const std::vector<OcrLine>& lines, const std::vector<cv::Rect>& regions, std::vector<OcrLine>* kept);
+
+// Runs the pipeline on each region crop and appends the lines in image
+// coordinates. Returns the summed Predict time in ms.
+double ocrRegions(PaddleOCR& ocr, const cv::Mat& image, const std::vector<cv::Rect>& regions,
+                  const std::string& spool_dir, const std::string& name, std::vector<OcrLine>* lines);
+
+// Helper function to sort lines top-to-bottom, then left-to-right
+void sortLinesReadingOrder(std::vector<OcrLine>* lines);
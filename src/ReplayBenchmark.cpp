@@ -0,0 +1,308 @@
+#include "ReplayBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "BoundedQueue.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <queue>
+#include <random>
+#include <thread>
+
+namespace {
+
+struct OutputTask {
+    std::vector<std::unique_ptr<BaseCVResult> > outputs;
+    OcrRequestPtr request;
+    bool finished = false;               // queued after the request's last page; no outputs
+    OcrRequest::Clock::time_point done;  // when that last page finished inference
+};
+
+// Arrival (or deferred retry) waiting for its time, earliest first
+struct PendingArrival {
+    OcrRequest::Clock::time_point at;
+    OcrRequestPtr request;
+    int deferrals = 0;
+    bool operator<(const PendingArrival& other) const { return at > other.at; }
+};
+
+OcrRequest::Clock::duration fromMs(double ms) {
+    return std::chrono::duration_cast<OcrRequest::Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+}
+
+}  // namespace
+
+bool loadReplayTrace(const std::string& path, std::vector<ReplayEvent>* events, std::string* error) {
+    std::ifstream in(path);
+    if (!in) {
+        *error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        nlohmann::json item = nlohmann::json::parse(line, nullptr, false);
+        if (item.is_discarded() || !item.is_object() || !item.contains("images") || !item["images"].is_array()) {
+            *error = path + ":" + std::to_string(line_number) + ": expected {\"at_ms\", \"class\", \"images\", \"deadline_ms\"}";
+            return false;
+        }
+        ReplayEvent event;
+        event.at_ms = item.value("at_ms", 0.0);
+        event.request_class = item.value("class", std::string("bulk")) == "interactive" ? kInteractive : kBulk;
+        event.images = item["images"].get<std::vector<std::string> >();
+        event.deadline_ms = item.value("deadline_ms", 0.0);
+        events->push_back(event);
+    }
+    std::stable_sort(events->begin(), events->end(), [](const ReplayEvent& a, const ReplayEvent& b) {
+        return a.at_ms < b.at_ms;
+    });
+    return true;
+}
+
+std::vector<ReplayEvent> synthesizeReplayTrace(const std::vector<std::string>& images, const ReplayOptions& options) {
+    std::vector<ReplayEvent> events;
+    if (images.empty()) return events;
+    std::mt19937 rng(42);
+    const double duration_ms = options.duration_s * 1000.0;
+
+    // Bulk jobs land early so interactive traffic has to get past them
+    for (int j = 0; j < options.bulk_jobs; j++) {
+        ReplayEvent bulk;
+        bulk.at_ms = duration_ms * 0.5 * j / std::max(1, options.bulk_jobs);
+        bulk.request_class = kBulk;
+        bulk.images = images;
+        events.push_back(bulk);
+    }
+    if (options.interactive_rps > 0) {
+        std::exponential_distribution<double> gap_ms(options.interactive_rps / 1000.0);
+        std::uniform_int_distribution<size_t> pick(0, images.size() - 1);
+        for (double at = gap_ms(rng); at < duration_ms; at += gap_ms(rng)) {
+            ReplayEvent interactive;
+            interactive.at_ms = at;
+            interactive.request_class = kInteractive;
+            interactive.images.push_back(images[pick(rng)]);
+            interactive.deadline_ms = options.deadline_ms;
+            events.push_back(interactive);
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), [](const ReplayEvent& a, const ReplayEvent& b) {
+        return a.at_ms < b.at_ms;
+    });
+    return events;
+}
+
+ReplaySummary runReplay(const std::vector<ReplayEvent>& events,
+                        const std::vector<PaddleOCR*>& engines,
+                        const ReplayOptions& options) {
+    ReplaySummary summary;
+    if (engines.empty()) return summary;
+    const int workers = static_cast<int>(engines.size());
+    RequestScheduler scheduler(options.strict_priority, workers, options.admission);
+    BoundedQueue<OutputTask> output_queue(std::max<size_t>(1, options.output_queue) * workers);
+    std::mutex stats_mutex;
+
+    auto record_expired = [&](const OcrRequestPtr& request) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        summary.classes[request->request_class].expired++;
+    };
+
+    // A request counts once all of its pages are saved, so failed saves are not goodput
+    auto record_finished = [&](const OcrRequestPtr& request, OcrRequest::Clock::time_point done) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        ReplayClassStats& stats = summary.classes[request->request_class];
+        if (request->failed) {
+            stats.failed++;
+            return;
+        }
+        stats.completed++;
+        stats.latencies_ms.push_back(elapsedMs(request->arrival, done));
+        if (request->Expired(done)) {
+            stats.late++;
+        } else {
+            stats.on_time++;
+        }
+    };
+
+    // Output stage: blocks workers through the bounded queue when it falls behind. Tasks
+    // arrive in order, so a request's finish marker comes after all of its pages.
+    std::thread writer([&]() {
+        OutputTask task;
+        while (output_queue.Pop(&task)) {
+            if (!options.output_dir.empty()) {
+                for (auto& output : task.outputs) {
+                    try {
+                        output->SaveToJson(options.output_dir);
+                    } catch (const std::exception& e) {
+                        task.request->failed = true;
+                        std::lock_guard<std::mutex> lock(stats_mutex);
+                        std::cerr << "  [ERROR] Saving replay results failed: " << e.what() << std::endl;
+                    }
+                }
+            }
+            if (task.finished) record_finished(task.request, task.done);
+        }
+    });
+
+    auto worker_loop = [&](int worker_id) {
+        PaddleOCR* ocr = engines[worker_id];
+        OcrRequestPtr request;
+        std::vector<OcrRequestPtr> expired;
+        while (scheduler.Next(&request, &expired)) {
+            for (const auto& dropped : expired) record_expired(dropped);
+            expired.clear();
+
+            bool dropped = false;
+            bool preempted = false;
+            int pages = 0;
+            while (request->next_page < request->pages.size()) {
+                if (request->Expired(OcrRequest::Clock::now())) {
+                    dropped = true;
+                    break;
+                }
+                try {
+                    OcrRequest::Clock::time_point page_start = OcrRequest::Clock::now();
+                    OutputTask task;
+                    task.outputs = ocr->Predict(request->pages[request->next_page]);
+                    task.request = request;
+                    scheduler.RecordPageCost(elapsedMs(page_start, OcrRequest::Clock::now()));
+                    output_queue.Push(std::move(task));
+                } catch (const std::exception& e) {
+                    request->failed = true;
+                    std::lock_guard<std::mutex> lock(stats_mutex);
+                    std::cerr << "  [ERROR] Replay page " << request->pages[request->next_page] << " failed: " << e.what() << std::endl;
+                }
+                request->next_page++;
+                pages++;
+                if (request->failed) break; // the request cannot complete; free the worker
+                // Stage boundary: let waiting higher-priority work go first
+                if (request->next_page < request->pages.size() &&
+                    scheduler.HigherPriorityWaiting(request->request_class)) {
+                    preempted = true;
+                    break;
+                }
+            }
+
+            OcrRequest::Clock::time_point done = OcrRequest::Clock::now();
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex);
+                ReplayClassStats& stats = summary.classes[request->request_class];
+                stats.pages += pages;
+                if (dropped) {
+                    stats.expired++;
+                } else if (preempted) {
+                    stats.preemptions++;
+                    request->preemptions++;
+                    scheduler.Requeue(request);
+                }
+            }
+            if (!dropped && !preempted) {
+                // Counted by the writer once the pages queued before this marker are saved
+                OutputTask marker;
+                marker.request = request;
+                marker.finished = true;
+                marker.done = done;
+                output_queue.Push(std::move(marker));
+            }
+        }
+        for (const auto& dropped : expired) record_expired(dropped);
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < workers; w++) {
+        pool.emplace_back(worker_loop, w);
+    }
+    OcrRequest::Clock::time_point start = OcrRequest::Clock::now();
+    std::thread submitter([&]() {
+        std::priority_queue<PendingArrival> pending;
+        int next_id = 0;
+        for (const auto& event : events) {
+            PendingArrival arrival;
+            arrival.at = start + fromMs(event.at_ms);
+            arrival.request = std::make_shared<OcrRequest>();
+            arrival.request->id = next_id++;
+            arrival.request->request_class = event.request_class;
+            arrival.request->pages = event.images;
+            if (event.deadline_ms > 0) {
+                // Deadline relative to the trace arrival time, kept across deferrals
+                arrival.request->deadline = arrival.at + fromMs(event.deadline_ms);
+            }
+            pending.push(arrival);
+        }
+        while (!pending.empty()) {
+            PendingArrival arrival = pending.top();
+            pending.pop();
+            std::this_thread::sleep_until(arrival.at);
+            OcrRequestPtr request = arrival.request;
+            if (arrival.deferrals == 0) {
+                request->arrival = arrival.at;
+                std::lock_guard<std::mutex> lock(stats_mutex);
+                summary.classes[request->request_class].submitted++;
+                if (request->deadline != OcrRequest::Clock::time_point::max()) {
+                    summary.classes[request->request_class].with_deadline++;
+                }
+            }
+            double retry_after_ms = 0.0;
+            AdmissionDecision decision = scheduler.Admit(request, &retry_after_ms);
+            if (decision == kAdmitted) continue;
+
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            ReplayClassStats& stats = summary.classes[request->request_class];
+            if (decision == kDeferred && arrival.deferrals < options.max_deferrals) {
+                stats.deferrals++;
+                arrival.deferrals++;
+                arrival.at = OcrRequest::Clock::now() + fromMs(retry_after_ms);
+                pending.push(arrival);
+            } else {
+                stats.rejected++;
+            }
+        }
+        scheduler.Close();
+    });
+    worker_loop(0);
+    for (auto& t : pool) t.join();
+    submitter.join();
+    output_queue.Close();
+    writer.join();
+
+    summary.wall_ms = elapsedMs(start, OcrRequest::Clock::now());
+    summary.output_queue_high_water = output_queue.HighWater();
+    return summary;
+}
+
+std::vector<OverloadPoint> runOverloadSweep(const std::vector<std::string>& images,
+                                            const std::vector<PaddleOCR*>& engines,
+                                            const ReplayOptions& options,
+                                            const std::vector<double>& loads) {
+    std::vector<OverloadPoint> points;
+    const double capacity_rps = engines.size() * 1000.0 / std::max(1.0, options.admission.initial_page_ms);
+    for (double load : loads) {
+        ReplayOptions level = options;
+        level.bulk_jobs = 0;
+        level.interactive_rps = load * capacity_rps;
+        std::vector<ReplayEvent> events = synthesizeReplayTrace(images, level);
+        ReplaySummary summary = runReplay(events, engines, level);
+
+        OverloadPoint point;
+        point.load = load;
+        point.offered_rps = level.interactive_rps;
+        point.stats = summary.classes[kInteractive];
+        point.goodput_rps = point.stats.on_time * 1000.0 / std::max(1.0, summary.wall_ms);
+        point.reject_rate = point.stats.submitted > 0 ? static_cast<double>(point.stats.rejected) / point.stats.submitted : 0.0;
+        point.p99_ms = percentile(point.stats.latencies_ms, 99);
+        points.push_back(point);
+    }
+    return points;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include "RequestScheduler.h"
+#include <string>
+#include <vector>
+
+struct ReplayOptions {
+    std::string trace_path;       // JSONL trace; empty = synthesize one from the benchmark images
+    double duration_s = 20.0;     // synthetic trace length
+    double interactive_rps = 1.0; // synthetic interactive arrivals per second (Poisson)
+    double deadline_ms = 1500.0;  // synthetic interactive deadline, relative to arrival
+    int bulk_jobs = 2;            // synthetic bulk jobs, each over all benchmark images
+    int workers = 1;              // PaddleOCR instances serving the queue
+    bool strict_priority = true;  // false = plain FIFO baseline
+    AdmissionLimits admission;    // queue bounds and cost based admission
+    int max_deferrals = 3;        // bulk retries before a deferred request counts as rejected
+    size_t output_queue = 4;      // results waiting for the output stage, per worker
+    std::string output_dir;       // output stage writes <stem>_res.json here; empty = results are discarded
+};
+
+// One request in a replay trace. JSONL form:
+// {"at_ms": 120, "class": "interactive", "images": ["images/image_1.png"], "deadline_ms": 1500}
+struct ReplayEvent {
+    double at_ms = 0.0;
+    RequestClass request_class = kBulk;
+    std::vector<std::string> images;
+    double deadline_ms = 0.0; // 0 = no deadline
+};
+
+struct ReplayClassStats {
+    int submitted = 0;
+    int with_deadline = 0;
+    int completed = 0;
+    int on_time = 0;   // completed within the deadline (or completed, without one)
+    int rejected = 0;  // turned away by admission control
+    int deferrals = 0; // times a bulk request was told to come back later
+    int expired = 0;   // dropped before (the rest of) their inference
+    int late = 0;      // completed after their deadline
+    int failed = 0;    // a page failed in Predict or SaveToJson; neither completed nor on time
+    int preemptions = 0;
+    int pages = 0;
+    std::vector<double> latencies_ms; // arrival to completion of completed requests
+};
+
+struct ReplaySummary {
+    ReplayClassStats classes[kRequestClassCount];
+    double wall_ms = 0.0;
+    size_t output_queue_high_water = 0;
+};
+
+// One offered load level of the overload sweep
+struct OverloadPoint {
+    double load = 0.0;        // offered rate / estimated capacity
+    double offered_rps = 0.0;
+    double goodput_rps = 0.0; // on-time completions per second
+    double reject_rate = 0.0;
+    double p99_ms = 0.0;
+    ReplayClassStats stats;
+};
+
+// Helper function to read a JSONL replay trace
+bool loadReplayTrace(const std::string& path, std::vector<ReplayEvent>* events, std::string* error);
+
+// Helper function to build a trace of Poisson interactive single-page requests
+// with deadlines over bulk jobs covering all images (fixed seed, reproducible)
+std::vector<ReplayEvent> synthesizeReplayTrace(const std::vector<std::string>& images, const ReplayOptions& options);
+
+// Replays the trace against a request queue served by one worker per engine,
+// as a server would: requests arrive at their trace time and pass admission
+// control, expired ones are dropped before inference, bulk requests yield to
+// waiting interactive ones between pages, and results go through a bounded
+// output stage.
+ReplaySummary runReplay(const std::vector<ReplayEvent>& events,
+                        const std::vector<PaddleOCR*>& engines,
+                        const ReplayOptions& options);
+
+// Offered-load sweep with interactive requests only: each level replays
+// `load` x the estimated capacity (engines / page cost) for options.duration_s.
+std::vector<OverloadPoint> runOverloadSweep(const std::vector<std::string>& images,
+                                            const std::vector<PaddleOCR*>& engines,
+                                            const ReplayOptions& options,
+                                            const std::vector<double>& loads);
+
+// Helper function to get a nearest-rank percentile (p in [0, 100]) of unsorted values
+double percentile(std::vector<double> values, double p);
@@ -0,0 +1,151 @@
+#include "RequestScheduler.h"
+
+#include <algorithm>
+
+namespace {
+
+const double kPageCostSmoothing = 0.1; // EWMA weight of the newest page time
+
+size_t remainingPages(const OcrRequest& request) {
+    return request.pages.size() - request.next_page;
+}
+
+}  // namespace
+
+const char* requestClassName(RequestClass request_class) {
+    switch (request_class) {
+        case kInteractive: return "interactive";
+        case kBulk: return "bulk";
+        default: return "unknown";
+    }
+}
+
+const char* admissionDecisionName(AdmissionDecision decision) {
+    switch (decision) {
+        case kAdmitted: return "admitted";
+        case kRejected: return "rejected";
+        case kDeferred: return "deferred";
+        default: return "unknown";
+    }
+}
+
+RequestScheduler::RequestScheduler(bool strict_priority, int workers, const AdmissionLimits& limits)
+    : strict_priority_(strict_priority),
+      workers_(std::max(1, workers)),
+      limits_(limits),
+      page_ms_(limits.initial_page_ms) {}
+
+void RequestScheduler::PushLocked(const OcrRequestPtr& request, bool front) {
+    std::deque<OcrRequestPtr>& queue = queues_[QueueIndex(request->request_class)];
+    if (front) {
+        queue.push_front(request);
+    } else {
+        queue.push_back(request);
+    }
+    queued_pages_[request->request_class] += remainingPages(*request);
+}
+
+void RequestScheduler::Submit(const OcrRequestPtr& request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PushLocked(request, false);
+    }
+    ready_.notify_one();
+}
+
+AdmissionDecision RequestScheduler::Admit(const OcrRequestPtr& request, double* retry_after_ms) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!limits_.enabled) {
+            PushLocked(request, false);
+        } else {
+            const RequestClass request_class = request->request_class;
+            const size_t pages = remainingPages(*request);
+
+            // Work that will be served before this request
+            size_t pages_ahead = 0;
+            for (int c = 0; c < kRequestClassCount; c++) {
+                if (!strict_priority_ || c <= request_class) pages_ahead += queued_pages_[c];
+            }
+            const double wait_ms = pages_ahead * page_ms_ / workers_;
+
+            // A request larger than the bound still gets in once its class queue is empty,
+            // otherwise a long bulk job could never be admitted
+            if (queued_pages_[request_class] > 0 &&
+                queued_pages_[request_class] + pages > limits_.max_queued_pages[request_class]) {
+                if (request_class == kBulk) {
+                    // Come back once roughly the current backlog has drained
+                    *retry_after_ms = std::max(page_ms_, wait_ms);
+                    return kDeferred;
+                }
+                return kRejected;
+            }
+            OcrRequest::Clock::time_point finish = OcrRequest::Clock::now() +
+                std::chrono::duration_cast<OcrRequest::Clock::duration>(
+                    std::chrono::duration<double, std::milli>(wait_ms + pages * page_ms_));
+            if (request->deadline != OcrRequest::Clock::time_point::max() && finish > request->deadline) {
+                return kRejected;
+            }
+            PushLocked(request, false);
+        }
+    }
+    ready_.notify_one();
+    return kAdmitted;
+}
+
+void RequestScheduler::RecordPageCost(double page_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    page_ms_ += kPageCostSmoothing * (page_ms - page_ms_);
+}
+
+double RequestScheduler::EstimatedPageMs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return page_ms_;
+}
+
+void RequestScheduler::Requeue(const OcrRequestPtr& request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PushLocked(request, true);
+    }
+    ready_.notify_one();
+}
+
+bool RequestScheduler::Next(OcrRequestPtr* request, std::vector<OcrRequestPtr>* expired) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        OcrRequest::Clock::time_point now = OcrRequest::Clock::now();
+        for (auto& queue : queues_) {
+            while (!queue.empty()) {
+                OcrRequestPtr head = queue.front();
+                queue.pop_front();
+                queued_pages_[head->request_class] -= remainingPages(*head);
+                if (head->Expired(now)) {
+                    expired->push_back(head);
+                    continue;
+                }
+                *request = head;
+                return true;
+            }
+        }
+        if (closed_) return false;
+        ready_.wait(lock);
+    }
+}
+
+bool RequestScheduler::HigherPriorityWaiting(RequestClass request_class) const {
+    if (!strict_priority_) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int c = 0; c < request_class; c++) {
+        if (!queues_[c].empty()) return true;
+    }
+    return false;
+}
+
+void RequestScheduler::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    ready_.notify_all();
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum RequestClass {
+    kInteractive = 0, // single pages a user is waiting on
+    kBulk = 1,        // batch jobs, preemptible between pages
+    kRequestClassCount = 2
+};
+
+const char* requestClassName(RequestClass request_class);
+
+struct OcrRequest {
+    typedef std::chrono::steady_clock Clock;
+
+    int id = 0;
+    RequestClass request_class = kBulk;
+    std::vector<std::string> pages;
+    size_t next_page = 0; // pages before this one are done
+    Clock::time_point arrival;
+    Clock::time_point deadline = Clock::time_point::max();
+    int preemptions = 0;
+    std::atomic<bool> failed{false}; // a page failed in Predict or while its results were saved
+
+    bool Expired(Clock::time_point now) const { return now > deadline; }
+};
+
+typedef std::shared_ptr<OcrRequest> OcrRequestPtr;
+
+enum AdmissionDecision {
+    kAdmitted,
+    kRejected, // would miss its deadline or no room; fail fast
+    kDeferred  // bulk request with no room now; retry after the suggested delay
+};
+
+const char* admissionDecisionName(AdmissionDecision decision);
+
+struct AdmissionLimits {
+    bool enabled = true;
+    size_t max_queued_pages[kRequestClassCount] = {8, 64}; // queue bound per class, in pages (an empty class always admits)
+    double initial_page_ms = 200.0;                        // cost estimate until pages have been timed
+};
+
+// Work queue with strict priority between classes and FIFO within a class.
+// Requests past their deadline are dropped when they reach the head of the
+// queue, before any inference is spent on them. With strict_priority off
+// everything is served in arrival order (baseline for comparisons).
+//
+// Admission control bounds the queued pages per class and estimates each
+// request's completion time from the pages queued ahead of it and a running
+// per-page cost, so excess load is turned away at the door instead of
+// piling up in memory.
+class RequestScheduler {
+public:
+    explicit RequestScheduler(bool strict_priority = true, int workers = 1,
+                              const AdmissionLimits& limits = AdmissionLimits());
+
+    // Queues the request unconditionally
+    void Submit(const OcrRequestPtr& request);
+
+    // Queues the request if admission allows it. retry_after_ms is set for kDeferred.
+    AdmissionDecision Admit(const OcrRequestPtr& request, double* retry_after_ms);
+
+    // Feeds the running page cost estimate used by Admit
+    void RecordPageCost(double page_ms);
+
+    double EstimatedPageMs() const;
+
+    // A preempted request resumes ahead of the rest of its class
+    void Requeue(const OcrRequestPtr& request);
+
+    // Blocks until a live request is available; expired requests passed on the
+    // way are appended to `expired`. Returns false once closed and drained.
+    bool Next(OcrRequestPtr* request, std::vector<OcrRequestPtr>* expired);
+
+    // True when a request of a higher class than `request_class` is waiting
+    bool HigherPriorityWaiting(RequestClass request_class) const;
+
+    void Close();
+
+private:
+    int QueueIndex(RequestClass request_class) const { return strict_priority_ ? request_class : 0; }
+    void PushLocked(const OcrRequestPtr& request, bool front);
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<OcrRequestPtr> queues_[kRequestClassCount];
+    size_t queued_pages_[kRequestClassCount] = {0, 0}; // per request class, not per queue
+    bool strict_priority_;
+    int workers_;
+    AdmissionLimits limits_;
+    double page_ms_;
+    bool closed_ = false;
+};
@@ -0,0 +1,164 @@
+#include "ResultVisualizer.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+const int kMinTextHeight = 8;
+const int kMaxTextHeight = 48;
+
+// Helper function to pick a stable, distinct color per line index
+cv::Scalar lineColor(size_t index) {
+    static const cv::Scalar kPalette[] = {
+        cv::Scalar(255, 0, 0), cv::Scalar(0, 160, 0), cv::Scalar(0, 0, 255), cv::Scalar(200, 0, 200),
+        cv::Scalar(0, 160, 200), cv::Scalar(200, 120, 0), cv::Scalar(120, 0, 255), cv::Scalar(0, 120, 120)};
+    return kPalette[index % (sizeof(kPalette) / sizeof(kPalette[0]))];
+}
+
+// Helper function to decode the next UTF-8 code point starting at *pos
+uint32_t nextCodePoint(const std::string& text, size_t* pos) {
+    unsigned char lead = static_cast<unsigned char>(text[(*pos)++]);
+    int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+    uint32_t code_point = extra == 0 ? lead : (lead & (0x3F >> extra));
+    for (int i = 0; i < extra && *pos < text.size(); i++) {
+        code_point = (code_point << 6) | (static_cast<unsigned char>(text[(*pos)++]) & 0x3F);
+    }
+    return code_point;
+}
+
+#ifdef USE_FREETYPE
+// Helper function to encode one code point as UTF-8
+std::string utf8Encode(uint32_t code_point) {
+    std::string out;
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    return out;
+}
+#endif
+
+}  // namespace
+
+GlyphAtlas::GlyphAtlas(const std::string& font_path) {
+#ifdef USE_FREETYPE
+    if (font_path.empty()) return;
+    try {
+        font_ = cv::freetype::createFreeType2();
+        font_->loadFontData(font_path, 0);
+        has_font_ = true;
+    } catch (const std::exception& e) {
+        font_.reset();
+        std::cerr << "[WARNING] Cannot load visualization font " << font_path << ": " << e.what() << std::endl;
+    }
+#else
+    if (!font_path.empty()) {
+        std::cerr << "[WARNING] Built without USE_FREETYPE; ignoring visualization font " << font_path << std::endl;
+    }
+#endif
+}
+
+const cv::Mat& GlyphAtlas::Glyph(uint32_t code_point, int height) {
+    std::pair<uint32_t, int> key(code_point, height);
+    std::map<std::pair<uint32_t, int>, cv::Mat>::const_iterator cached = glyphs_.find(key);
+    if (cached != glyphs_.end()) return cached->second;
+
+    cv::Mat glyph;
+#ifdef USE_FREETYPE
+    if (has_font_ && code_point > 0x20) {
+        const std::string text = utf8Encode(code_point);
+        // Pixel size a bit under the cell so descenders stay inside it
+        const int font_height = std::max(1, height * 4 / 5);
+        int baseline = 0;
+        cv::Size size = font_->getTextSize(text, font_height, -1, &baseline);
+        glyph = cv::Mat(height, std::max(1, size.width), CV_8UC1, cv::Scalar(0));
+        font_->putText(glyph, text, cv::Point(0, height - std::max(1, baseline)), font_height, cv::Scalar(255), -1,
+                       cv::LINE_AA, true);
+        return glyphs_.insert(std::make_pair(key, glyph)).first->second;
+    }
+#endif
+    if (code_point > 0x20 && code_point < 0x7F) {
+        const std::string text(1, static_cast<char>(code_point));
+        // Hershey sizes are relative to a ~22px cap height at scale 1
+        double font_scale = height / 30.0;
+        int thickness = std::max(1, height / 16);
+        int baseline = 0;
+        cv::Size size = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, font_scale, thickness, &baseline);
+        glyph = cv::Mat(height, std::max(1, size.width + thickness), CV_8UC1, cv::Scalar(0));
+        cv::putText(glyph, text, cv::Point(0, height - std::max(1, baseline)), cv::FONT_HERSHEY_SIMPLEX, font_scale,
+                    cv::Scalar(255), thickness, cv::LINE_AA);
+    } else if (code_point <= 0x20) {
+        glyph = cv::Mat(height, std::max(1, height / 3), CV_8UC1, cv::Scalar(0));
+    } else {
+        // Wide glyph placeholder, one em square
+        glyph = cv::Mat(height, height, CV_8UC1, cv::Scalar(0));
+        int inset = std::max(1, height / 8);
+        cv::rectangle(glyph, cv::Rect(inset, inset, height - 2 * inset, height - 2 * inset), cv::Scalar(255), 1);
+    }
+    return glyphs_.insert(std::make_pair(key, glyph)).first->second;
+}
+
+bool saveFastVisualization(const cv::Mat& image, const std::vector<OcrLine>& lines, const std::string& stem,
+                           const VisualizationOptions& options, GlyphAtlas* atlas, const std::string& output_dir) {
+    if (image.empty()) return false;
+    const double scale = options.scale > 0 && options.scale < 1 ? options.scale : 1.0;
+    cv::Mat page;
+    if (scale < 1.0) {
+        cv::resize(image, page, cv::Size(std::max(1, static_cast<int>(image.cols * scale)),
+                                         std::max(1, static_cast<int>(image.rows * scale))),
+                   0, 0, cv::INTER_AREA);
+    } else {
+        page = image.clone();
+    }
+
+    cv::Mat canvas(page.rows, page.cols * 2, CV_8UC3, cv::Scalar(255, 255, 255));
+    cv::Mat left = canvas(cv::Rect(0, 0, page.cols, page.rows));
+    cv::Mat right = canvas(cv::Rect(page.cols, 0, page.cols, page.rows));
+    page.copyTo(left);
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].poly.empty()) continue;
+        std::vector<cv::Point> poly;
+        for (const auto& p : lines[i].poly) {
+            poly.push_back(cv::Point(static_cast<int>(p.x * scale), static_cast<int>(p.y * scale)));
+        }
+        const cv::Scalar color = lineColor(i);
+        cv::polylines(left, std::vector<std::vector<cv::Point> >(1, poly), true, color, 1);
+        cv::polylines(right, std::vector<std::vector<cv::Point> >(1, poly), true, color, 1);
+
+        cv::Rect box = cv::boundingRect(poly) & cv::Rect(0, 0, right.cols, right.rows);
+        if (box.area() <= 0) continue;
+        int height = std::min(kMaxTextHeight, std::max(kMinTextHeight, static_cast<int>(box.height * 0.8)));
+        height = std::min(height, right.rows);
+        int x = box.x;
+        int y = std::min(box.y + std::max(0, (box.height - height) / 2), right.rows - height);
+        size_t pos = 0;
+        while (pos < lines[i].text.size()) {
+            const cv::Mat& glyph = atlas->Glyph(nextCodePoint(lines[i].text, &pos), height);
+            if (x + glyph.cols > right.cols) break;
+            right(cv::Rect(x, y, glyph.cols, glyph.rows)).setTo(color, glyph);
+            x += glyph.cols;
+        }
+    }
+
+    std::vector<int> params;
+    std::string extension = options.format == "png" ? "png" : "jpg";
+    if (extension == "png") {
+        params = {cv::IMWRITE_PNG_COMPRESSION, 1};
+    } else {
+        params = {cv::IMWRITE_JPEG_QUALITY, options.jpeg_quality};
+    }
+    return cv::imwrite(output_dir + stem + "_ocr_res_img." + extension, canvas, params);
+}
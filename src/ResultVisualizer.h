@@ -0,0 +1,49 @@
+#pragma once
+
+#include "OcrResultJson.h"
+#include <opencv2/opencv.hpp>
+#ifdef USE_FREETYPE
+#include <opencv2/freetype.hpp>
+#endif
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct VisualizationOptions {
+    std::string mode = "full";  // "full": pipeline SaveToImg, "fast": renderer below, "off": none
+    int every = 1;              // visualize every Nth image only
+    double scale = 0.5;         // fast mode: output resolution relative to the page
+    std::string format = "jpg"; // fast mode: "jpg" or "png" (low compression)
+    int jpeg_quality = 80;
+    std::string font_path;      // fast mode: TrueType font for the text panel (default: the pipeline's vis_font_dir)
+};
+
+// Glyph masks rendered once per (code point, height) and reused for every
+// later line. With a font (USE_FREETYPE builds, as for the pipeline's own
+// visualization) every code point is rendered through cv::freetype, so CJK
+// text is readable. Without one, printable ASCII falls back to the built-in
+// Hershey font and other code points to outlined boxes.
+class GlyphAtlas {
+public:
+    explicit GlyphAtlas(const std::string& font_path = "");
+
+    // False when no font was given, it failed to load, or FreeType is not built in
+    bool HasFont() const { return has_font_; }
+
+    const cv::Mat& Glyph(uint32_t code_point, int height);
+
+private:
+    std::map<std::pair<uint32_t, int>, cv::Mat> glyphs_;
+    bool has_font_ = false;
+#ifdef USE_FREETYPE
+    cv::Ptr<cv::freetype::FreeType2> font_;
+#endif
+};
+
+// Side-by-side visualization like the pipeline's SaveToImg (page with line
+// polygons on the left, recognized text at the same positions on the right),
+// drawn at options.scale and written as <output_dir><stem>_ocr_res_img.<format>.
+bool saveFastVisualization(const cv::Mat& image, const std::vector<OcrLine>& lines, const std::string& stem,
+                           const VisualizationOptions& options, GlyphAtlas* atlas, const std::string& output_dir);
@@ -0,0 +1,61 @@
+#include "SpooledPredict.h"
+#include "BenchmarkUtils.h"
+#include "PageStream.h"
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+std::string spoolDirectory(const std::string& fallback_dir) {
+    return isDirectory("/dev/shm") ? "/dev/shm" : fallback_dir;
+}
+
+bool predictSpooledImage(PaddleOCR& ocr, const cv::Mat& image, const std::string& spool_dir,
+                         const std::string& name, std::vector<OcrLine>* lines, double* inference_ms,
+                         const std::string& json_dir) {
+    const std::string spool_path = spool_dir + "/" + name + ".bmp";
+    const std::string save_dir = json_dir.empty() ? spool_dir + "/" : json_dir;
+    const std::string json_path = save_dir + name + "_res.json";
+
+    // BMP is uncompressed: cheapest lossless hand-off to the path based Predict
+    if (!cv::imwrite(spool_path, image)) {
+        throw std::runtime_error("cannot write spool file " + spool_path);
+    }
+
+    bool ok = false;
+    try {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto outputs = ocr.Predict(spool_path);
+        auto end = std::chrono::high_resolution_clock::now();
+        *inference_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+
+        for (auto& output : outputs) {
+            output->SaveToJson(save_dir);
+        }
+        ok = loadOcrLines(json_path, lines);
+    } catch (...) {
+        std::remove(spool_path.c_str());
+        throw;
+    }
+    std::remove(spool_path.c_str());
+    if (json_dir.empty()) std::remove(json_path.c_str());
+    return ok;
+}
+
+bool predictImageFile(PaddleOCR& ocr, const std::string& image_path, const std::string& spool_dir,
+                      std::vector<OcrLine>* lines, double* inference_ms, const std::string& json_dir) {
+    const std::string save_dir = json_dir.empty() ? spool_dir + "/" : json_dir;
+    const std::string json_path = save_dir + documentStem(image_path) + "_res.json";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto outputs = ocr.Predict(image_path);
+    auto end = std::chrono::high_resolution_clock::now();
+    *inference_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+
+    for (auto& output : outputs) {
+        output->SaveToJson(save_dir);
+    }
+    bool ok = loadOcrLines(json_path, lines);
+    if (json_dir.empty()) std::remove(json_path.c_str());
+    return ok;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include "OcrResultJson.h"
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// PaddleOCR::Predict takes image paths, so in-memory images (TIFF pages, video
+// frames, crops) are handed over through an uncompressed spool file.
+
+// Helper function to pick the spool directory: RAM backed /dev/shm when present
+std::string spoolDirectory(const std::string& fallback_dir);
+
+// Runs the pipeline on an in-memory image named `name` (used for the spool file and
+// the pipeline's <name>_res.json). Recognized lines are returned in image coordinates;
+// inference_ms covers Predict only. The spool image is removed again, and so is the
+// JSON unless json_dir is given, in which case <json_dir><name>_res.json is kept.
+bool predictSpooledImage(PaddleOCR& ocr, const cv::Mat& image, const std::string& spool_dir,
+                         const std::string& name, std::vector<OcrLine>* lines, double* inference_ms,
+                         const std::string& json_dir = "");
+
+// Same for an image file: the pipeline decodes it itself and names the JSON after its stem
+bool predictImageFile(PaddleOCR& ocr, const std::string& image_path, const std::string& spool_dir,
+                      std::vector<OcrLine>* lines, double* inference_ms, const std::string& json_dir = "");
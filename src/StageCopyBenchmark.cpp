@@ -0,0 +1,74 @@
+#include "StageCopyBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PaddleStage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+// Helper function to time `runs` Predict calls on one page; returns bytes copied / shared per call
+std::vector<OcrLine> timePredict(BatchOcr& ocr, const cv::Mat& image, int runs, double* ms,
+                                 double* copied_bytes, double* shared_bytes) {
+    StageCopyCounters before = stageCopyCounters();
+    std::vector<OcrLine> lines;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int run = 0; run < runs; run++) lines = ocr.Predict(std::vector<cv::Mat>(1, image))[0];
+    *ms = elapsedMs(start) / runs;
+    StageCopyCounters after = stageCopyCounters();
+    *copied_bytes = static_cast<double>(after.copied_bytes - before.copied_bytes) / runs;
+    *shared_bytes = static_cast<double>(after.shared_bytes - before.shared_bytes) / runs;
+    return lines;
+}
+
+}  // namespace
+
+StageCopySummary runStageCopyBenchmark(const std::vector<std::string>& images, BatchOcr& ocr, int runs) {
+    StageCopySummary summary;
+    if (runs < 1) runs = 1;
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            DecodedImage decoded;
+            if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image");
+
+            double copy_ms = 0.0, zero_copy_ms = 0.0;
+            double copied_before = 0.0, copied_after = 0.0, shared_before = 0.0, shared_after = 0.0;
+            ocr.SetZeroCopy(false);
+            std::vector<OcrLine> copied = timePredict(ocr, decoded.image, runs, &copy_ms, &copied_before, &shared_before);
+            ocr.SetZeroCopy(true);
+            std::vector<OcrLine> shared = timePredict(ocr, decoded.image, runs, &zero_copy_ms, &copied_after, &shared_after);
+
+            int mismatches = copied.size() == shared.size() ? 0 : static_cast<int>(std::max(copied.size(), shared.size()));
+            for (size_t i = 0; i < copied.size() && i < shared.size(); i++) {
+                if (copied[i].text != shared[i].text) mismatches++;
+            }
+
+            summary.images++;
+            summary.text_mismatches += mismatches;
+            summary.copied_bytes_before += copied_before;
+            summary.copied_bytes_after += copied_after;
+            summary.shared_bytes_after += shared_after;
+            summary.copy_ms += copy_ms;
+            summary.zero_copy_ms += zero_copy_ms;
+
+            std::cout << "STAGE_COPY_RESULT:{\"filename\":\"" << filename
+                      << "\",\"copied_bytes_before\":" << std::fixed << std::setprecision(0) << copied_before
+                      << ",\"copied_bytes_after\":" << copied_after
+                      << ",\"shared_bytes_after\":" << shared_after
+                      << ",\"copy_ms\":" << std::setprecision(2) << copy_ms
+                      << ",\"zero_copy_ms\":" << zero_copy_ms
+                      << ",\"text_mismatches\":" << mismatches << "}" << std::endl;
+        } catch (const std::exception& e) {
+            ocr.SetZeroCopy(true);
+            summary.failed++;
+            std::cerr << "  [ERROR] Stage copy benchmark failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "BatchOcr.h"
+#include <string>
+#include <vector>
+
+struct StageCopySummary {
+    int images = 0;
+    int failed = 0;
+    int text_mismatches = 0;          // lines read differently with shared tensors
+    double copied_bytes_before = 0.0; // CopyFromCpu / CopyToCpu bytes, summed over images (one run each)
+    double copied_bytes_after = 0.0;
+    double shared_bytes_after = 0.0;  // bytes bound or read in place instead
+    double copy_ms = 0.0;             // Predict time, sums of per-image averages
+    double zero_copy_ms = 0.0;
+};
+
+// Runs each image through `ocr` `runs` times with stage tensors copied
+// (ocr.SetZeroCopy(false)) and with pooled shared buffers, and prints a
+// STAGE_COPY_RESULT line per image with the bytes copied per run of each.
+// Leaves zero copy enabled on the stages of `ocr`.
+StageCopySummary runStageCopyBenchmark(const std::vector<std::string>& images, BatchOcr& ocr, int runs);
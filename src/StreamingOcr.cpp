@@ -0,0 +1,113 @@
+#include "StreamingOcr.h"
+#include "BenchmarkUtils.h"
+#include "ImageDecoder.h"
+#include "PageStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+StreamingOcr::StreamingOcr(TextDetector& detector, TextRecognizer& recognizer, TextlineClassifier* textline,
+                           const DetectorConfig& config, int first_batch_size)
+    : detector_(detector), recognizer_(recognizer), textline_(textline), config_(config),
+      first_batch_size_(std::max(1, first_batch_size)) {}
+
+int StreamingOcr::Predict(const cv::Mat& image, const LineCallback& on_line) {
+    auto start = std::chrono::high_resolution_clock::now();
+    // Boxes come back from det sorted top to bottom, then left to right
+    std::vector<DetectedBox> boxes;
+    detector_.Detect(image, config_, &boxes);
+
+    const size_t batch_size = static_cast<size_t>(recognizer_.BatchSize());
+    size_t begin = 0;
+    while (begin < boxes.size()) {
+        size_t end = std::min(boxes.size(), begin + (begin == 0 ? static_cast<size_t>(first_batch_size_) : batch_size));
+        std::vector<cv::Mat> crops;
+        for (size_t i = begin; i < end; i++) crops.push_back(cropTextRegion(image, boxes[i].quad));
+        if (textline_ != nullptr) {
+            std::vector<bool> flipped;
+            textline_->Classify(crops, &flipped);
+            for (size_t k = 0; k < crops.size(); k++) {
+                if (flipped[k] && !crops[k].empty()) cv::rotate(crops[k], crops[k], cv::ROTATE_180);
+            }
+        }
+        std::vector<RecognizedText> texts;
+        recognizer_.Recognize(crops, &texts);
+
+        for (size_t i = begin; i < end; i++) {
+            StreamedLine streamed;
+            streamed.index = i;
+            streamed.line.poly = boxes[i].quad;
+            streamed.line.text = texts[i - begin].text;
+            streamed.line.score = texts[i - begin].score;
+            streamed.elapsed_ms = elapsedMs(start);
+            on_line(streamed);
+        }
+        begin = end;
+    }
+    return static_cast<int>(boxes.size());
+}
+
+StreamingSummary runStreamingBenchmark(const std::vector<std::string>& images,
+                                       BatchOcr& full,
+                                       StreamingOcr& streaming,
+                                       int runs,
+                                       const std::string& output_dir) {
+    StreamingSummary summary;
+    if (runs < 1) runs = 1;
+    mkdir(output_dir.c_str(), 0755);
+
+    for (const auto& image_path : images) {
+        const std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            DecodedImage decoded;
+            if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image");
+            const cv::Mat& image = decoded.image;
+
+            double full_ms = 0.0;
+            double first_line_ms = 0.0;
+            double total_ms = 0.0;
+            std::vector<OcrLine> lines;
+            for (int run = 0; run < runs; run++) {
+                auto full_start = std::chrono::high_resolution_clock::now();
+                full.Predict(std::vector<cv::Mat>(1, image));
+                full_ms += elapsedMs(full_start);
+
+                lines.clear();
+                double first_ms = -1.0;
+                auto stream_start = std::chrono::high_resolution_clock::now();
+                streaming.Predict(image, [&](const StreamedLine& streamed) {
+                    if (first_ms < 0) first_ms = streamed.elapsed_ms;
+                    lines.push_back(streamed.line);
+                });
+                double stream_ms = elapsedMs(stream_start);
+                // A page without text has no first line; its wait is the whole call
+                first_line_ms += first_ms < 0 ? stream_ms : first_ms;
+                total_ms += stream_ms;
+            }
+            full_ms /= runs;
+            first_line_ms /= runs;
+            total_ms /= runs;
+            saveOcrLines(output_dir + documentStem(image_path) + "_res.json", image_path, lines);
+
+            summary.images++;
+            summary.lines += static_cast<int>(lines.size());
+            summary.full_ms += full_ms;
+            summary.first_line_ms += first_line_ms;
+            summary.stream_total_ms += total_ms;
+
+            std::cout << "STREAM_RESULT:{\"filename\":\"" << filename
+                      << "\",\"lines\":" << lines.size()
+                      << ",\"full_ms\":" << std::fixed << std::setprecision(2) << full_ms
+                      << ",\"first_line_ms\":" << first_line_ms
+                      << ",\"last_line_ms\":" << total_ms << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Streaming OCR failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "BatchOcr.h"
+#include "OcrResultJson.h"
+#include "TextDetector.h"
+#include "TextRecognizer.h"
+#include "TextlineClassifier.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+struct StreamedLine {
+    size_t index = 0;        // position in reading order
+    OcrLine line;
+    double elapsed_ms = 0.0; // since Predict was called
+};
+
+typedef std::function<void(const StreamedLine&)> LineCallback;
+
+// Page OCR that hands out lines while the page is still being recognized.
+// Det boxes are taken in reading order (top to bottom) and recognized in
+// small batches; each batch's lines go to the callback as soon as it
+// finishes, so the top of the page arrives first. The first batch is kept
+// smaller to shorten the time to the first line.
+class StreamingOcr {
+public:
+    StreamingOcr(TextDetector& detector, TextRecognizer& recognizer, TextlineClassifier* textline,
+                 const DetectorConfig& config = DetectorConfig(), int first_batch_size = 2);
+
+    // Calls on_line once per line, in reading order, from the calling thread.
+    // Returns the number of lines.
+    int Predict(const cv::Mat& image, const LineCallback& on_line);
+
+private:
+    TextDetector& detector_;
+    TextRecognizer& recognizer_;
+    TextlineClassifier* textline_;
+    DetectorConfig config_;
+    int first_batch_size_;
+};
+
+struct StreamingSummary {
+    int images = 0;
+    int failed = 0;
+    int lines = 0;
+    double full_ms = 0.0;        // whole-page Predict, sums of per-image averages
+    double first_line_ms = 0.0;  // streaming: time to first line
+    double stream_total_ms = 0.0; // streaming: time to last line
+};
+
+// Times `full` (results only when the page is done) against `streaming` on
+// each image, `runs` times, and prints a STREAM_RESULT line per image with
+// the time to first line. Streamed lines are saved as <output_dir><stem>_res.json.
+StreamingSummary runStreamingBenchmark(const std::vector<std::string>& images,
+                                       BatchOcr& full,
+                                       StreamingOcr& streaming,
+                                       int runs,
+                                       const std::string& output_dir);
@@ -0,0 +1,198 @@
+#include "TemplateOcr.h"
+#include "ImageDecoder.h"
+#include "OcrResultJson.h"
+#include "PageStream.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+
+bool parseRegion(const nlohmann::json& item, size_t index, TemplateRegion* region, std::string* error) {
+    if (!item.is_object() || !item.contains("bbox") || !item["bbox"].is_array() || item["bbox"].size() < 3) {
+        *error = "region " + std::to_string(index) + " has no bbox polygon";
+        return false;
+    }
+    for (const auto& point : item["bbox"]) {
+        if (!point.is_array() || point.size() < 2) {
+            *error = "region " + std::to_string(index) + " has a malformed bbox point";
+            return false;
+        }
+        region->quad.push_back(cv::Point(point[0].get<int>(), point[1].get<int>()));
+    }
+    if (item.contains("name") && item["name"].is_string()) {
+        region->name = item["name"].get<std::string>();
+    } else {
+        region->name = "roi_" + std::to_string(index);
+    }
+    region->detect = item.value("detect", false);
+    region->charset = item.value("charset", std::string());
+    return true;
+}
+
+std::vector<cv::Point> scaleQuad(const std::vector<cv::Point>& quad, double sx, double sy) {
+    std::vector<cv::Point> scaled;
+    for (const auto& p : quad) {
+        scaled.push_back(cv::Point(static_cast<int>(p.x * sx + 0.5), static_cast<int>(p.y * sy + 0.5)));
+    }
+    return scaled;
+}
+
+// One pass over an image: direct regions are recognized as one line each, detect regions
+// are detected on their crop; every line then goes to rec in one batch
+void recognizeForm(const cv::Mat& image, const FormTemplate& layout, TextRecognizer& recognizer,
+                   const std::vector<RecCharset>& charsets, TextDetector* detector,
+                   std::vector<OcrLine>* lines) {
+    double sx = layout.width > 0 ? static_cast<double>(image.cols) / layout.width : 1.0;
+    double sy = layout.height > 0 ? static_cast<double>(image.rows) / layout.height : 1.0;
+    const cv::Rect image_rect(0, 0, image.cols, image.rows);
+
+    std::vector<cv::Mat> crops;
+    std::vector<size_t> crop_region;
+    std::vector<size_t> crop_line;
+    std::vector<const RecCharset*> crop_charsets;
+    std::vector<std::vector<OcrLine> > region_lines(layout.regions.size());
+    for (size_t r = 0; r < layout.regions.size(); r++) {
+        const TemplateRegion& region = layout.regions[r];
+        const RecCharset* charset = charsets[r].classes.empty() ? nullptr : &charsets[r];
+        std::vector<cv::Point> quad = scaleQuad(region.quad, sx, sy);
+        if (region.detect && detector != nullptr) {
+            cv::Rect bounds = cv::boundingRect(quad) & image_rect;
+            if (bounds.area() == 0) continue;
+            const cv::Mat roi = image(bounds);
+            std::vector<DetectedBox> boxes;
+            detector->Detect(roi, DetectorConfig(), &boxes);
+            for (const auto& box : boxes) {
+                crops.push_back(cropTextRegion(roi, box.quad));
+                crop_region.push_back(r);
+                crop_line.push_back(region_lines[r].size());
+                crop_charsets.push_back(charset);
+                OcrLine line;
+                for (const auto& point : box.quad) line.poly.push_back(point + bounds.tl());
+                region_lines[r].push_back(line);
+            }
+        } else {
+            crops.push_back(cropTextRegion(image, quad));
+            crop_region.push_back(r);
+            crop_line.push_back(0);
+            crop_charsets.push_back(charset);
+            OcrLine line;
+            line.poly = quad;
+            region_lines[r].push_back(line);
+        }
+    }
+
+    std::vector<RecognizedText> texts;
+    recognizer.Recognize(crops, &texts, crop_charsets);
+    for (size_t i = 0; i < crops.size(); i++) {
+        OcrLine& line = region_lines[crop_region[i]][crop_line[i]];
+        line.text = texts[i].text;
+        line.score = texts[i].score;
+    }
+
+    // Layout order, so rec_texts line up with the template regions
+    lines->clear();
+    for (const auto& group : region_lines) {
+        lines->insert(lines->end(), group.begin(), group.end());
+    }
+}
+
+}  // namespace
+
+bool loadFormTemplate(const std::string& path, FormTemplate* layout, std::string* error) {
+    std::ifstream in(path);
+    if (!in) {
+        *error = "cannot open " + path;
+        return false;
+    }
+    nlohmann::json root = nlohmann::json::parse(in, nullptr, false);
+    if (root.is_discarded()) {
+        *error = "invalid JSON in " + path;
+        return false;
+    }
+
+    const nlohmann::json* regions = &root;
+    if (root.is_object()) {
+        layout->width = root.value("width", 0);
+        layout->height = root.value("height", 0);
+        if (!root.contains("regions")) {
+            *error = "layout object has no \"regions\" array";
+            return false;
+        }
+        regions = &root["regions"];
+    }
+    if (!regions->is_array() || regions->empty()) {
+        *error = "layout has no regions";
+        return false;
+    }
+    for (size_t i = 0; i < regions->size(); i++) {
+        TemplateRegion region;
+        if (!parseRegion((*regions)[i], i, &region, error)) return false;
+        layout->regions.push_back(region);
+    }
+    return true;
+}
+
+TemplateOcrSummary runTemplateOcr(const std::vector<std::string>& images,
+                                  const FormTemplate& layout,
+                                  TextRecognizer& recognizer,
+                                  TextDetector* detector,
+                                  int runs,
+                                  const std::map<std::string, double>& full_pipeline_ms,
+                                  const std::string& output_dir) {
+    TemplateOcrSummary summary;
+    if (runs < 1) runs = 1;
+    mkdir(output_dir.c_str(), 0755);
+    // Per-region charsets resolved once against the rec dictionary
+    std::vector<RecCharset> charsets(layout.regions.size());
+    for (size_t r = 0; r < layout.regions.size(); r++) {
+        if (!layout.regions[r].charset.empty()) charsets[r] = recognizer.Charset(layout.regions[r].charset);
+    }
+    for (const auto& region : layout.regions) {
+        if (region.detect && detector != nullptr) {
+            summary.regions_detected++;
+        } else {
+            summary.regions_recognized++;
+        }
+    }
+
+    for (const auto& image_path : images) {
+        std::string filename = image_path.substr(image_path.find_last_of('/') + 1);
+        try {
+            std::vector<OcrLine> lines;
+            double total_ms = 0.0;
+            for (int run = 0; run < runs; run++) {
+                // Decode is inside the timing, as it is inside the pipeline's Predict
+                auto start = std::chrono::high_resolution_clock::now();
+                DecodedImage decoded;
+                if (!decodeImage(image_path, 0, &decoded)) throw std::runtime_error("cannot decode image");
+                const cv::Mat& image = decoded.image;
+                recognizeForm(image, layout, recognizer, charsets, detector, &lines);
+                auto end = std::chrono::high_resolution_clock::now();
+                total_ms += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+            }
+            double avg_ms = total_ms / runs;
+            saveOcrLines(output_dir + documentStem(image_path) + "_res.json", image_path, lines);
+            summary.images++;
+            summary.total_ms += avg_ms;
+
+            std::map<std::string, double>::const_iterator full = full_pipeline_ms.find(filename);
+            std::cout << "TEMPLATE_RESULT:{\"filename\":\"" << filename
+                      << "\",\"template_ms\":" << std::fixed << std::setprecision(2) << avg_ms;
+            if (full != full_pipeline_ms.end()) {
+                std::cout << ",\"full_pipeline_ms\":" << full->second
+                          << ",\"speedup\":" << (avg_ms > 0 ? full->second / avg_ms : 0.0);
+            }
+            std::cout << ",\"regions\":" << layout.regions.size() << ",\"lines\":" << lines.size() << "}" << std::endl;
+        } catch (const std::exception& e) {
+            summary.failed++;
+            std::cerr << "  [ERROR] Template OCR failed for " << image_path << ": " << e.what() << std::endl;
+        }
+    }
+    return summary;
+}
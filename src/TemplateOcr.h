@@ -0,0 +1,49 @@
+#pragma once
+
+#include "TextDetector.h"
+#include "TextRecognizer.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// One fixed field of a form layout
+struct TemplateRegion {
+    std::string name;
+    std::vector<cv::Point> quad; // same 4-point format as labels.json bbox
+    bool detect = false;         // run det on the region's crop instead of recognizing it as one line
+    std::string charset;         // restrict rec to these classes ("digits", "date", "ascii", "alnum" or literal characters)
+};
+
+// Form layout. width/height give the reference size the quads were drawn on;
+// when set, quads are scaled to each image's actual size.
+struct FormTemplate {
+    int width = 0;
+    int height = 0;
+    std::vector<TemplateRegion> regions;
+};
+
+// Helper function to load a layout file: either a plain array of regions
+// ({"bbox": [[x,y] x4], "name": ..., "detect": ..., "charset": ...}; a labels.json image entry
+// works as is) or {"width": W, "height": H, "regions": [...]}.
+bool loadFormTemplate(const std::string& path, FormTemplate* layout, std::string* error);
+
+struct TemplateOcrSummary {
+    int images = 0;
+    int failed = 0;
+    int regions_recognized = 0; // sent straight to rec
+    int regions_detected = 0;   // went through local det + rec
+    double total_ms = 0.0;      // sum of per-image averages
+};
+
+// OCR of fixed-layout forms: every region is cropped and recognized directly,
+// skipping full-page detection; `detect` regions run `detector` on the in-memory
+// crop and their lines join the same rec batch. Each image runs `runs` times and the average is reported on a
+// TEMPLATE_RESULT line next to the full pipeline time from full_pipeline_ms
+// (keyed by file name). Results are saved as <output_dir><stem>_res.json.
+TemplateOcrSummary runTemplateOcr(const std::vector<std::string>& images,
+                                  const FormTemplate& layout,
+                                  TextRecognizer& recognizer,
+                                  TextDetector* detector,
+                                  int runs,
+                                  const std::map<std::string, double>& full_pipeline_ms,
+                                  const std::string& output_dir);
@@ -0,0 +1,228 @@
+#include "TextDetector.h"
+#include "PaddleStage.h"
+
+#include <polyclipping/clipper.hpp>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+const int kMaxCandidates = 1000;
+const float kMinBoxSide = 3.0f;
+
+// Resize so both sides are multiples of 32, within the configured limits
+cv::Mat resizeForDetection(const cv::Mat& image, const DetectorConfig& config) {
+    int h = image.rows;
+    int w = image.cols;
+    double ratio = 1.0;
+    if (config.limit_type == "max") {
+        if (std::max(h, w) > config.limit_side_len) ratio = static_cast<double>(config.limit_side_len) / std::max(h, w);
+    } else if (std::min(h, w) < config.limit_side_len) {
+        ratio = static_cast<double>(config.limit_side_len) / std::min(h, w);
+    }
+    if (std::max(h, w) * ratio > config.max_side_limit) {
+        ratio = static_cast<double>(config.max_side_limit) / std::max(h, w);
+    }
+    int resize_h = std::max(static_cast<int>(std::round(h * ratio / 32)) * 32, 32);
+    int resize_w = std::max(static_cast<int>(std::round(w * ratio / 32)) * 32, 32);
+    cv::Mat resized;
+    cv::resize(image, resized, cv::Size(resize_w, resize_h));
+    return resized;
+}
+
+// Minimum-area rectangle as tl, tr, br, bl; returns its shorter side
+float miniBox(const std::vector<cv::Point2f>& points, cv::Point2f box[4]) {
+    cv::RotatedRect rect = cv::minAreaRect(points);
+    cv::Point2f corners[4];
+    rect.points(corners);
+    std::sort(corners, corners + 4, [](const cv::Point2f& a, const cv::Point2f& b) { return a.x < b.x; });
+    int tl = corners[0].y <= corners[1].y ? 0 : 1;
+    int bl = 1 - tl;
+    int tr = corners[2].y <= corners[3].y ? 2 : 3;
+    int br = 5 - tr;
+    box[0] = corners[tl];
+    box[1] = corners[tr];
+    box[2] = corners[br];
+    box[3] = corners[bl];
+    return std::min(rect.size.width, rect.size.height);
+}
+
+// Mean probability inside the box
+float boxScore(const cv::Mat& prob, const cv::Point2f box[4]) {
+    float min_x = box[0].x, max_x = box[0].x, min_y = box[0].y, max_y = box[0].y;
+    for (int i = 1; i < 4; i++) {
+        min_x = std::min(min_x, box[i].x);
+        max_x = std::max(max_x, box[i].x);
+        min_y = std::min(min_y, box[i].y);
+        max_y = std::max(max_y, box[i].y);
+    }
+    int x0 = std::max(0, static_cast<int>(std::floor(min_x)));
+    int x1 = std::min(prob.cols - 1, static_cast<int>(std::ceil(max_x)));
+    int y0 = std::max(0, static_cast<int>(std::floor(min_y)));
+    int y1 = std::min(prob.rows - 1, static_cast<int>(std::ceil(max_y)));
+    if (x1 < x0 || y1 < y0) return 0.0f;
+
+    cv::Mat mask = cv::Mat::zeros(y1 - y0 + 1, x1 - x0 + 1, CV_8UC1);
+    std::vector<cv::Point> polygon;
+    for (int i = 0; i < 4; i++) {
+        polygon.push_back(cv::Point(static_cast<int>(box[i].x) - x0, static_cast<int>(box[i].y) - y0));
+    }
+    cv::fillPoly(mask, std::vector<std::vector<cv::Point> >(1, polygon), cv::Scalar(1));
+    return static_cast<float>(cv::mean(prob(cv::Rect(x0, y0, x1 - x0 + 1, y1 - y0 + 1)), mask)[0]);
+}
+
+// Grow the box by area * ratio / perimeter, as DB does to undo its shrunk training targets
+std::vector<cv::Point2f> unclip(const cv::Point2f box[4], float unclip_ratio) {
+    double area = 0.0;
+    double perimeter = 0.0;
+    for (int i = 0; i < 4; i++) {
+        const cv::Point2f& a = box[i];
+        const cv::Point2f& b = box[(i + 1) % 4];
+        area += a.x * b.y - a.y * b.x;
+        perimeter += std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+    }
+    area = std::fabs(area) / 2.0;
+    double distance = perimeter > 0 ? area * unclip_ratio / perimeter : 0.0;
+
+    ClipperLib::Path path;
+    for (int i = 0; i < 4; i++) {
+        path.push_back(ClipperLib::IntPoint(static_cast<ClipperLib::cInt>(box[i].x),
+                                            static_cast<ClipperLib::cInt>(box[i].y)));
+    }
+    ClipperLib::ClipperOffset offset;
+    offset.AddPath(path, ClipperLib::jtRound, ClipperLib::etClosedPolygon);
+    ClipperLib::Paths solution;
+    offset.Execute(solution, distance);
+
+    std::vector<cv::Point2f> expanded;
+    if (!solution.empty()) {
+        for (const auto& point : solution[0]) {
+            expanded.push_back(cv::Point2f(static_cast<float>(point.X), static_cast<float>(point.Y)));
+        }
+    }
+    return expanded;
+}
+
+// NCHW with ImageNet mean / std, applied to BGR as the pipeline does
+void fillDetectionInput(const cv::Mat& resized, float* input) {
+    const int h = resized.rows;
+    const int w = resized.cols;
+    const float mean[3] = {0.485f, 0.456f, 0.406f};
+    const float scale[3] = {1.0f / (0.229f * 255.0f), 1.0f / (0.224f * 255.0f), 1.0f / (0.225f * 255.0f)};
+    for (int y = 0; y < h; y++) {
+        const uchar* row = resized.ptr<uchar>(y);
+        for (int x = 0; x < w; x++) {
+            for (int c = 0; c < 3; c++) {
+                input[(static_cast<size_t>(c) * h + y) * w + x] = row[x * 3 + c] * scale[c] - mean[c] * 255.0f * scale[c];
+            }
+        }
+    }
+}
+
+// DB post-processing of one probability map into boxes in image coordinates
+void boxesFromProbMap(const cv::Mat& prob, const cv::Size& image_size, const DetectorConfig& config,
+                      std::vector<DetectedBox>* boxes) {
+    boxes->clear();
+    cv::Mat bitmap;
+    cv::threshold(prob, bitmap, config.thresh, 255, cv::THRESH_BINARY);
+    bitmap.convertTo(bitmap, CV_8U);
+    std::vector<std::vector<cv::Point> > contours;
+    cv::findContours(bitmap, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+
+    const float sx = static_cast<float>(image_size.width) / prob.cols;
+    const float sy = static_cast<float>(image_size.height) / prob.rows;
+    const size_t candidates = std::min(contours.size(), static_cast<size_t>(kMaxCandidates));
+    for (size_t i = 0; i < candidates; i++) {
+        if (contours[i].size() <= 2) continue;
+        std::vector<cv::Point2f> points(contours[i].begin(), contours[i].end());
+        cv::Point2f box[4];
+        if (miniBox(points, box) < kMinBoxSide) continue;
+        float score = boxScore(prob, box);
+        if (score < config.box_thresh) continue;
+
+        std::vector<cv::Point2f> expanded = unclip(box, config.unclip_ratio);
+        if (expanded.size() < 3) continue;
+        if (miniBox(expanded, box) < kMinBoxSide + 2) continue;
+
+        DetectedBox detected;
+        detected.score = score;
+        for (int k = 0; k < 4; k++) {
+            int x = static_cast<int>(std::round(box[k].x * sx));
+            int y = static_cast<int>(std::round(box[k].y * sy));
+            detected.quad.push_back(cv::Point(std::min(std::max(x, 0), image_size.width - 1),
+                                              std::min(std::max(y, 0), image_size.height - 1)));
+        }
+        boxes->push_back(detected);
+    }
+
+    // Reading order: top to bottom, then boxes within 10px vertically left to right
+    std::sort(boxes->begin(), boxes->end(), [](const DetectedBox& a, const DetectedBox& b) {
+        return a.quad[0].y != b.quad[0].y ? a.quad[0].y < b.quad[0].y : a.quad[0].x < b.quad[0].x;
+    });
+    for (size_t i = 1; i < boxes->size(); i++) {
+        for (size_t j = i; j > 0; j--) {
+            const cv::Point& upper = (*boxes)[j - 1].quad[0];
+            const cv::Point& lower = (*boxes)[j].quad[0];
+            if (std::abs(lower.y - upper.y) >= 10 || lower.x >= upper.x) break;
+            std::swap((*boxes)[j - 1], (*boxes)[j]);
+        }
+    }
+}
+
+}  // namespace
+
+TextDetector::TextDetector(const std::string& model_dir, const std::string& device, int cpu_threads)
+    : predictor_(model_dir, device, cpu_threads) {}
+
+void TextDetector::Detect(const cv::Mat& image, const DetectorConfig& config, std::vector<DetectedBox>* boxes) {
+    std::vector<std::vector<DetectedBox> > per_image;
+    DetectBatch(std::vector<cv::Mat>(1, image), config, &per_image);
+    boxes->swap(per_image[0]);
+}
+
+int TextDetector::DetectBatch(const std::vector<cv::Mat>& images, const DetectorConfig& config,
+                               std::vector<std::vector<DetectedBox> >* boxes) {
+    boxes->assign(images.size(), std::vector<DetectedBox>());
+
+    // Bucket by network input shape; each bucket is one predictor run
+    std::vector<cv::Mat> resized(images.size());
+    std::map<std::pair<int, int>, std::vector<size_t> > buckets;
+    for (size_t i = 0; i < images.size(); i++) {
+        resized[i] = resizeForDetection(images[i], config);
+        if (resized[i].channels() == 1) {
+            cv::cvtColor(resized[i], resized[i], cv::COLOR_GRAY2BGR);
+        }
+        buckets[std::make_pair(resized[i].rows, resized[i].cols)].push_back(i);
+    }
+
+    for (const auto& bucket : buckets) {
+        const int h = bucket.first.first;
+        const int w = bucket.first.second;
+        const int batch = static_cast<int>(bucket.second.size());
+        const size_t plane = static_cast<size_t>(3) * h * w;
+        float* input = predictor_.Input({batch, 3, h, w});
+        for (int b = 0; b < batch; b++) {
+            fillDetectionInput(resized[bucket.second[b]], input + plane * b);
+        }
+
+        if (!predictor_.Run()) {
+            throw std::runtime_error("detection predictor failed");
+        }
+        std::vector<int> shape;
+        const float* probs = predictor_.Output(&shape); // [batch, 1, h, w]
+        if (shape.size() != 4 || shape[0] != batch) {
+            throw std::runtime_error("unexpected detection output shape");
+        }
+        const size_t map_size = static_cast<size_t>(shape[2]) * shape[3];
+
+        for (int b = 0; b < batch; b++) {
+            size_t index = bucket.second[b];
+            // Header over the output tensor; boxesFromProbMap only reads it
+            cv::Mat prob(shape[2], shape[3], CV_32FC1, const_cast<float*>(probs + map_size * b));
+            boxesFromProbMap(prob, images[index].size(), config, &(*boxes)[index]);
+        }
+    }
+    return static_cast<int>(buckets.size());
+}
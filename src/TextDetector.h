@@ -0,0 +1,42 @@
+#pragma once
+
+#include "PaddleStage.h"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Resize and DB post-processing settings; defaults follow the OCR pipeline
+struct DetectorConfig {
+    int limit_side_len = 64;
+    std::string limit_type = "min"; // "min": shorter side at least limit_side_len, "max": longer side at most
+    int max_side_limit = 4000;
+    float thresh = 0.3f;
+    float box_thresh = 0.6f;
+    float unclip_ratio = 1.5f;
+};
+
+struct DetectedBox {
+    std::vector<cv::Point> quad; // tl, tr, br, bl in input image coordinates
+    float score = 0.0f;
+};
+
+// Detection model run directly on an image: DB probability map, contour
+// boxes scored against the map and expanded with clipper, sorted top to bottom.
+class TextDetector {
+public:
+    TextDetector(const std::string& model_dir, const std::string& device, int cpu_threads);
+
+    void Detect(const cv::Mat& image, const DetectorConfig& config, std::vector<DetectedBox>* boxes);
+
+    // Images that resize to the same network input share one predictor run;
+    // boxes[i] belongs to images[i]. Returns the number of predictor runs.
+    int DetectBatch(const std::vector<cv::Mat>& images, const DetectorConfig& config,
+                     std::vector<std::vector<DetectedBox> >* boxes);
+
+    // Stage tensors shared with pooled buffers (default) or copied, see StagePredictor
+    void SetZeroCopy(bool enabled) { predictor_.SetZeroCopy(enabled); }
+
+private:
+    StagePredictor predictor_;
+};
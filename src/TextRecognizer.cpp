@@ -0,0 +1,214 @@
+#include "TextRecognizer.h"
+#include "PaddleStage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+std::vector<std::string> utf8Characters(const std::string& text) {
+    std::vector<std::string> characters;
+    for (size_t i = 0; i < text.size();) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 1;
+        characters.push_back(text.substr(i, length));
+        i += length;
+    }
+    return characters;
+}
+
+float pointDistance(const cv::Point2f& a, const cv::Point2f& b) {
+    return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+}
+
+cv::Mat cropTextRegion(const cv::Mat& image, const std::vector<cv::Point>& quad) {
+    if (quad.size() != 4) {
+        cv::Rect bounds = cv::boundingRect(quad) & cv::Rect(0, 0, image.cols, image.rows);
+        return bounds.area() > 0 ? image(bounds).clone() : cv::Mat();
+    }
+    cv::Point2f src[4];
+    for (int i = 0; i < 4; i++) src[i] = cv::Point2f(quad[i].x, quad[i].y);
+    int width = static_cast<int>(std::max(pointDistance(src[0], src[1]), pointDistance(src[2], src[3])));
+    int height = static_cast<int>(std::max(pointDistance(src[0], src[3]), pointDistance(src[1], src[2])));
+    if (width < 1 || height < 1) return cv::Mat();
+
+    cv::Point2f dst[4] = {cv::Point2f(0, 0), cv::Point2f(width, 0),
+                          cv::Point2f(width, height), cv::Point2f(0, height)};
+    cv::Mat crop;
+    cv::warpPerspective(image, crop, cv::getPerspectiveTransform(src, dst), cv::Size(width, height),
+                        cv::INTER_CUBIC, cv::BORDER_REPLICATE);
+    if (crop.rows >= crop.cols * 1.5) {
+        cv::Mat rotated;
+        cv::rotate(crop, rotated, cv::ROTATE_90_COUNTERCLOCKWISE);
+        return rotated;
+    }
+    return crop;
+}
+
+TextRecognizer::TextRecognizer(const std::string& model_dir, const std::string& device, int cpu_threads, int batch_size)
+    : predictor_(model_dir, device, cpu_threads), batch_size_(std::max(1, batch_size)) {
+    YAML::Node config = loadStageConfig(model_dir);
+    YAML::Node dict = config["PostProcess"]["character_dict"];
+    if (!dict.IsSequence() || dict.size() == 0) {
+        throw std::runtime_error("no PostProcess.character_dict in " + model_dir + "/inference.yml");
+    }
+    charset_.push_back("");  // CTC blank
+    for (size_t i = 0; i < dict.size(); i++) {
+        charset_.push_back(dict[i].as<std::string>());
+    }
+    charset_.push_back(" "); // use_space_char
+
+    YAML::Node transforms = config["PreProcess"]["transform_ops"];
+    for (size_t i = 0; i < transforms.size(); i++) {
+        YAML::Node shape = transforms[i]["RecResizeImg"]["image_shape"];
+        if (shape.IsSequence() && shape.size() == 3) {
+            input_height_ = shape[1].as<int>();
+            min_input_width_ = shape[2].as<int>();
+        }
+    }
+}
+
+void TextRecognizer::Recognize(const std::vector<cv::Mat>& crops, std::vector<RecognizedText>* results) {
+    Recognize(crops, results, std::vector<const RecCharset*>());
+}
+
+void TextRecognizer::Recognize(const std::vector<cv::Mat>& crops, std::vector<RecognizedText>* results,
+                               const std::vector<const RecCharset*>& charsets) {
+    results->assign(crops.size(), RecognizedText());
+
+    // Batch crops of similar aspect ratio so little of each batch is padding
+    std::vector<size_t> order;
+    for (size_t i = 0; i < crops.size(); i++) {
+        if (!crops[i].empty()) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return crops[a].cols * crops[b].rows < crops[b].cols * crops[a].rows;
+    });
+
+    for (size_t start = 0; start < order.size(); start += batch_size_) {
+        size_t end = std::min(order.size(), start + static_cast<size_t>(batch_size_));
+        std::vector<size_t> batch(order.begin() + start, order.begin() + end);
+        RunBatch(crops, batch, charsets, results);
+    }
+}
+
+RecCharset TextRecognizer::Charset(const std::string& spec) const {
+    std::string characters = spec;
+    if (spec == "digits") {
+        characters = "0123456789";
+    } else if (spec == "date") {
+        characters = "0123456789-/.: 年月日";
+    } else if (spec == "alnum") {
+        characters = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    } else if (spec == "ascii") {
+        characters.clear();
+        for (char c = 0x20; c < 0x7F; c++) characters += c;
+    }
+
+    std::map<std::string, int> index;
+    for (size_t i = 1; i < charset_.size(); i++) index.insert(std::make_pair(charset_[i], static_cast<int>(i)));
+    RecCharset charset;
+    charset.name = spec;
+    charset.classes.push_back(0);
+    for (const auto& character : utf8Characters(characters)) {
+        std::map<std::string, int>::const_iterator it = index.find(character);
+        if (it == index.end()) continue;
+        charset.classes.push_back(it->second);
+        charset.characters.insert(character);
+    }
+    if (charset.classes.size() < 2) {
+        throw std::runtime_error("charset \"" + spec + "\" has no characters in the recognition dictionary");
+    }
+    std::sort(charset.classes.begin() + 1, charset.classes.end());
+    charset.classes.erase(std::unique(charset.classes.begin() + 1, charset.classes.end()), charset.classes.end());
+    return charset;
+}
+
+void TextRecognizer::RunBatch(const std::vector<cv::Mat>& crops, const std::vector<size_t>& indices,
+                              const std::vector<const RecCharset*>& charsets, std::vector<RecognizedText>* results) {
+    const int height = input_height_;
+    double max_ratio = static_cast<double>(min_input_width_) / height;
+    for (size_t index : indices) {
+        max_ratio = std::max(max_ratio, static_cast<double>(crops[index].cols) / crops[index].rows);
+    }
+    const int width = std::min(max_input_width_, static_cast<int>(height * max_ratio));
+    const int batch = static_cast<int>(indices.size());
+
+    // NCHW, (x / 255 - 0.5) / 0.5, zero padded on the right
+    float* input = predictor_.Input({batch, 3, height, width}, true);
+    std::vector<int> resized_widths(batch);
+    for (int b = 0; b < batch; b++) {
+        const cv::Mat& crop = crops[indices[b]];
+        int resized_width = std::min(width, static_cast<int>(std::ceil(height * static_cast<double>(crop.cols) / crop.rows)));
+        resized_width = std::max(1, resized_width);
+        resized_widths[b] = resized_width;
+        cv::Mat resized = crop;
+        if (crop.cols != resized_width || crop.rows != height) {
+            // Crops already cut at the input height (fused textline path) skip this
+            cv::resize(crop, resized, cv::Size(resized_width, height));
+        }
+        if (resized.channels() == 1) {
+            cv::cvtColor(resized, resized, cv::COLOR_GRAY2BGR);
+        }
+        float* plane = input + static_cast<size_t>(b) * 3 * height * width;
+        for (int y = 0; y < height; y++) {
+            const uchar* row = resized.ptr<uchar>(y);
+            for (int x = 0; x < resized_width; x++) {
+                for (int c = 0; c < 3; c++) {
+                    plane[(static_cast<size_t>(c) * height + y) * width + x] = row[x * 3 + c] / 127.5f - 1.0f;
+                }
+            }
+        }
+    }
+
+    if (!predictor_.Run()) {
+        throw std::runtime_error("recognition predictor failed");
+    }
+
+    std::vector<int> shape;
+    const float* probs = predictor_.Output(&shape); // [batch, steps, classes]
+    if (shape.size() != 3) {
+        throw std::runtime_error("unexpected recognition output rank");
+    }
+
+    auto decode_start = std::chrono::high_resolution_clock::now();
+    const int steps = shape[1];
+    const int classes = shape[2];
+    for (int b = 0; b < batch; b++) {
+        RecognizedText& result = (*results)[indices[b]];
+        const RecCharset* charset = charsets.empty() ? nullptr : charsets[indices[b]];
+        int previous = -1;
+        double score_sum = 0.0;
+        int score_count = 0;
+        for (int t = 0; t < steps; t++) {
+            const float* step = probs + (static_cast<size_t>(b) * steps + t) * classes;
+            int best = 0;
+            float score = 0.0f;
+            if (charset == nullptr) {
+                best = static_cast<int>(std::max_element(step, step + classes) - step);
+                score = step[best];
+            } else {
+                // Argmax and softmax mass over the allowed columns only
+                float mass = 0.0f;
+                for (int c : charset->classes) {
+                    if (c >= classes) break;
+                    mass += step[c];
+                    if (step[c] > step[best]) best = c;
+                }
+                score = mass > 0.0f ? step[best] / mass : 0.0f;
+            }
+            if (best != 0 && best != previous && best < static_cast<int>(charset_.size())) {
+                result.text += charset_[best];
+                result.char_x.push_back((t + 0.5f) * width / steps / resized_widths[b]);
+                result.char_scores.push_back(score);
+                score_sum += score;
+                score_count++;
+            }
+            previous = best;
+        }
+        result.score = score_count > 0 ? static_cast<float>(score_sum / score_count) : 0.0f;
+    }
+    auto decode_end = std::chrono::high_resolution_clock::now();
+    decode_ms_ += std::chrono::duration_cast<std::chrono::nanoseconds>(decode_end - decode_start).count() / 1e6;
+}
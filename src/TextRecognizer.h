@@ -0,0 +1,74 @@
+#pragma once
+
+#include "PaddleStage.h"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+struct RecognizedText {
+    std::string text;
+    float score = 0.0f;
+    std::vector<float> char_x;      // per character of text: CTC step center along the crop (0 = left edge, 1 = right edge)
+    std::vector<float> char_scores; // per character of text
+};
+
+// Output classes a field may produce, for constrained CTC decoding: the full
+// head still runs, and decoding scores only these and the blank, renormalized
+// over the subset.
+struct RecCharset {
+    std::string name;
+    std::vector<int> classes; // dictionary indices, ascending; 0 (blank) first
+    std::set<std::string> characters; // dictionary entries of classes[1..]
+};
+
+// Helper function to split a UTF-8 string into characters
+std::vector<std::string> utf8Characters(const std::string& text);
+
+// Helper function to get the Euclidean distance between two quad corners
+float pointDistance(const cv::Point2f& a, const cv::Point2f& b);
+
+// Helper function to cut a text quad out of an image, deskewed to an upright
+// rectangle the same way the pipeline crops detected boxes (tall crops are
+// rotated 90 degrees).
+cv::Mat cropTextRegion(const cv::Mat& image, const std::vector<cv::Point>& quad);
+
+// Recognition model run directly on crops: height-48 resize, batches of similar
+// aspect ratio, CTC greedy decode with the dictionary from inference.yml.
+class TextRecognizer {
+public:
+    TextRecognizer(const std::string& model_dir, const std::string& device, int cpu_threads, int batch_size = 6);
+
+    // Results are returned in the order of `crops`
+    void Recognize(const std::vector<cv::Mat>& crops, std::vector<RecognizedText>* results);
+
+    // As above; charsets[i] restricts crops[i] (nullptr = full dictionary)
+    void Recognize(const std::vector<cv::Mat>& crops, std::vector<RecognizedText>* results,
+                   const std::vector<const RecCharset*>& charsets);
+
+    // Charset from a preset ("digits", "date", "ascii", "alnum") or the literal
+    // characters of `spec`. Throws std::runtime_error when no character is in the dictionary.
+    RecCharset Charset(const std::string& spec) const;
+
+    int InputHeight() const { return input_height_; }
+    int MaxInputWidth() const { return max_input_width_; } // wider crops are squeezed to this width
+    int BatchSize() const { return batch_size_; }
+    int NumClasses() const { return static_cast<int>(charset_.size()); }
+    double DecodeMs() const { return decode_ms_; } // CTC decode time since construction
+
+    // Stage tensors shared with pooled buffers (default) or copied, see StagePredictor
+    void SetZeroCopy(bool enabled) { predictor_.SetZeroCopy(enabled); }
+
+private:
+    void RunBatch(const std::vector<cv::Mat>& crops, const std::vector<size_t>& indices,
+                  const std::vector<const RecCharset*>& charsets, std::vector<RecognizedText>* results);
+
+    StagePredictor predictor_;
+    std::vector<std::string> charset_; // index 0 is the CTC blank
+    int batch_size_;
+    int input_height_ = 48;
+    int min_input_width_ = 320;
+    int max_input_width_ = 3200; // same cap as the pipeline's rec resize
+    double decode_ms_ = 0.0;
+};
@@ -0,0 +1,71 @@
+#include "TextlineClassifier.h"
+#include "PaddleStage.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+TextlineClassifier::TextlineClassifier(const std::string& model_dir, const std::string& device, int cpu_threads,
+                                       int batch_size)
+    : predictor_(model_dir, device, cpu_threads), batch_size_(std::max(1, batch_size)) {
+    YAML::Node config = loadStageConfig(model_dir);
+    YAML::Node transforms = config["PreProcess"]["transform_ops"];
+    for (size_t i = 0; i < transforms.size(); i++) {
+        YAML::Node size = transforms[i]["ResizeImage"]["size"];
+        if (size.IsSequence() && size.size() == 2) {
+            input_width_ = size[0].as<int>();
+            input_height_ = size[1].as<int>();
+        }
+    }
+}
+
+void TextlineClassifier::Classify(const std::vector<cv::Mat>& crops, std::vector<bool>* flipped) {
+    flipped->assign(crops.size(), false);
+    for (size_t start = 0; start < crops.size(); start += batch_size_) {
+        RunBatch(crops, start, std::min(crops.size(), start + static_cast<size_t>(batch_size_)), flipped);
+    }
+}
+
+void TextlineClassifier::RunBatch(const std::vector<cv::Mat>& crops, size_t start, size_t end,
+                                  std::vector<bool>* flipped) {
+    static const float kMean[3] = {0.485f, 0.456f, 0.406f};
+    static const float kStd[3] = {0.229f, 0.224f, 0.225f};
+    const int height = input_height_;
+    const int width = input_width_;
+    const int batch = static_cast<int>(end - start);
+
+    // NCHW RGB, (x / 255 - mean) / std
+    float* input = predictor_.Input({batch, 3, height, width}, true);
+    for (int b = 0; b < batch; b++) {
+        const cv::Mat& crop = crops[start + b];
+        if (crop.empty()) continue;
+        cv::Mat resized;
+        cv::resize(crop, resized, cv::Size(width, height));
+        if (resized.channels() == 1) {
+            cv::cvtColor(resized, resized, cv::COLOR_GRAY2BGR);
+        }
+        float* plane = input + static_cast<size_t>(b) * 3 * height * width;
+        for (int y = 0; y < height; y++) {
+            const uchar* row = resized.ptr<uchar>(y);
+            for (int x = 0; x < width; x++) {
+                for (int c = 0; c < 3; c++) {
+                    float value = row[x * 3 + (2 - c)] / 255.0f;
+                    plane[(static_cast<size_t>(c) * height + y) * width + x] = (value - kMean[c]) / kStd[c];
+                }
+            }
+        }
+    }
+
+    if (!predictor_.Run()) {
+        throw std::runtime_error("textline orientation predictor failed");
+    }
+
+    std::vector<int> shape;
+    const float* probs = predictor_.Output(&shape); // [batch, 2]
+    if (shape.size() != 2 || shape[0] != batch || shape[1] < 2) {
+        throw std::runtime_error("unexpected textline orientation output shape");
+    }
+    for (int b = 0; b < batch; b++) {
+        const float* scores = probs + static_cast<size_t>(b) * shape[1];
+        (*flipped)[start + b] = scores[1] > scores[0];
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "PaddleStage.h"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Textline orientation model (0 / 180 degrees) run directly on crops: fixed
+// resize from inference.yml (160x80 for PP-LCNet_x1_0_textline_ori),
+// ImageNet normalization, argmax over the two classes.
+class TextlineClassifier {
+public:
+    TextlineClassifier(const std::string& model_dir, const std::string& device, int cpu_threads, int batch_size = 6);
+
+    // flipped[i] is true when crops[i] is upside down; results are in the order of `crops`
+    void Classify(const std::vector<cv::Mat>& crops, std::vector<bool>* flipped);
+
+    // Stage tensors shared with pooled buffers (default) or copied, see StagePredictor
+    void SetZeroCopy(bool enabled) { predictor_.SetZeroCopy(enabled); }
+
+private:
+    void RunBatch(const std::vector<cv::Mat>& crops, size_t start, size_t end, std::vector<bool>* flipped);
+
+    StagePredictor predictor_;
+    int batch_size_;
+    int input_width_ = 160;
+    int input_height_ = 80;
+};
@@ -0,0 +1,168 @@
+#include "VideoOcr.h"
+#include "BenchmarkUtils.h"
+#include "PageStream.h"
+#include "RegionOcr.h"
+#include "SpooledPredict.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const int kThumbnailWidth = 160;     // frame difference is measured at this width
+const int kPixelChangeThreshold = 24; // gray levels a thumbnail pixel must move to count as changed
+const int kRegionMargin = 16;        // full resolution padding around changed regions
+
+cv::Mat makeThumbnail(const cv::Mat& frame) {
+    cv::Mat gray;
+    if (frame.channels() == 1) {
+        gray = frame;
+    } else {
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    }
+    int width = std::min(kThumbnailWidth, frame.cols);
+    int height = std::max(1, frame.rows * width / std::max(1, frame.cols));
+    cv::Mat thumbnail;
+    cv::resize(gray, thumbnail, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+    return thumbnail;
+}
+
+// Changed regions in full resolution coordinates. Regions grow to cover every
+// previous line they touch, so a line is either reused whole or re-recognized whole.
+std::vector<cv::Rect> changedRegions(const cv::Mat& changed_mask, const cv::Size& frame_size,
+                                     const std::vector<OcrLine>& previous_lines) {
+    cv::Mat dilated;
+    cv::dilate(changed_mask, dilated, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)));
+    std::vector<std::vector<cv::Point> > contours;
+    cv::findContours(dilated, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    const double scale = static_cast<double>(frame_size.width) / changed_mask.cols;
+    const cv::Rect frame_rect(0, 0, frame_size.width, frame_size.height);
+    std::vector<cv::Rect> regions;
+    for (const auto& contour : contours) {
+        cv::Rect r = cv::boundingRect(contour);
+        cv::Rect scaled(static_cast<int>(r.x * scale) - kRegionMargin,
+                        static_cast<int>(r.y * scale) - kRegionMargin,
+                        static_cast<int>(r.width * scale) + 2 * kRegionMargin,
+                        static_cast<int>(r.height * scale) + 2 * kRegionMargin);
+        scaled &= frame_rect;
+        if (scaled.area() > 0) regions.push_back(scaled);
+    }
+    growRegionsOverLines(&regions, previous_lines, frame_rect);
+    return regions;
+}
+
+std::string frameName(const std::string& stem, int frame_index) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_frame%06d", frame_index);
+    return stem + suffix;
+}
+
+}  // namespace
+
+VideoOcrSummary runVideoOcr(const std::vector<std::string>& videos,
+                            PaddleOCR& infer,
+                            const VideoOcrOptions& options,
+                            const std::string& output_dir) {
+    VideoOcrSummary summary;
+    summary.videos = static_cast<int>(videos.size());
+    const std::string spool_dir = spoolDirectory(output_dir);
+    double decoded_pixels = 0.0;
+    double ocr_pixels = 0.0;
+    auto wall_start = std::chrono::high_resolution_clock::now();
+
+    for (const auto& video : videos) {
+        cv::VideoCapture capture(video);
+        if (!capture.isOpened()) {
+            std::cerr << "  [ERROR] Cannot open video: " << video << std::endl;
+            continue;
+        }
+        std::cout << "  [VIDEO] Processing " << video << " ("
+                  << static_cast<int>(capture.get(cv::CAP_PROP_FRAME_COUNT)) << " frames at "
+                  << std::fixed << std::setprecision(2) << capture.get(cv::CAP_PROP_FPS) << " fps)" << std::endl;
+
+        const std::string stem = documentStem(video);
+        cv::Mat reference_thumbnail; // thumbnail of the last processed frame
+        std::vector<OcrLine> lines;  // result of the last processed frame
+        cv::Mat frame;
+
+        for (int frame_index = 0;; frame_index++) {
+            auto decode_start = std::chrono::high_resolution_clock::now();
+            if (!capture.read(frame) || frame.empty()) break;
+            cv::Mat thumbnail = makeThumbnail(frame);
+            summary.decode_ms += elapsedMs(decode_start);
+            summary.frames++;
+            decoded_pixels += static_cast<double>(frame.rows) * frame.cols;
+
+            // Decide what to run from the changed pixels of the thumbnail
+            std::vector<cv::Rect> regions;
+            double changed_ratio = 1.0;
+            bool full = reference_thumbnail.empty() || reference_thumbnail.size() != thumbnail.size();
+            if (!full) {
+                cv::Mat diff;
+                cv::Mat changed_mask;
+                cv::absdiff(thumbnail, reference_thumbnail, diff);
+                cv::threshold(diff, changed_mask, kPixelChangeThreshold, 255, cv::THRESH_BINARY);
+                changed_ratio = static_cast<double>(cv::countNonZero(changed_mask)) / changed_mask.total();
+                if (changed_ratio < options.frame_diff_threshold) {
+                    summary.skipped_frames++;
+                    continue;
+                }
+                regions = changedRegions(changed_mask, frame.size(), lines);
+                double region_area = 0.0;
+                for (const auto& region : regions) region_area += region.area();
+                full = region_area > options.full_frame_ratio * frame.rows * frame.cols;
+            }
+            if (full) {
+                regions.assign(1, cv::Rect(0, 0, frame.cols, frame.rows));
+            }
+
+            std::vector<OcrLine> next_lines;
+            int reused = full ? 0 : keepLinesOutside(lines, regions, &next_lines);
+
+            const std::string name = frameName(stem, frame_index);
+            double inference_ms = 0.0;
+            bool ok = true;
+            try {
+                inference_ms = ocrRegions(infer, frame, regions, spool_dir, name, &next_lines);
+                for (const auto& region : regions) ocr_pixels += region.area();
+            } catch (const std::exception& e) {
+                std::cerr << "  [ERROR] Frame " << frame_index << " of " << video << " failed: " << e.what() << std::endl;
+                ok = false;
+            }
+            if (!ok) {
+                // Keep the old reference so the next frame is compared against a known result
+                summary.failed_frames++;
+                continue;
+            }
+
+            sortLinesReadingOrder(&next_lines);
+            lines.swap(next_lines);
+            reference_thumbnail = thumbnail;
+            summary.inference_ms += inference_ms;
+            summary.reused_lines += reused;
+            if (full) {
+                summary.full_frames++;
+            } else {
+                summary.partial_frames++;
+            }
+            saveOcrLines(output_dir + name + "_res.json", video, lines);
+
+            std::cout << "PER_FRAME_RESULT:{\"video\":\"" << video
+                      << "\",\"frame\":" << frame_index
+                      << ",\"mode\":\"" << (full ? "full" : "partial")
+                      << "\",\"regions\":" << regions.size()
+                      << ",\"changed_ratio\":" << std::fixed << std::setprecision(4) << changed_ratio
+                      << ",\"inference_ms\":" << std::setprecision(2) << inference_ms
+                      << ",\"lines\":" << lines.size()
+                      << ",\"reused_lines\":" << reused << "}" << std::endl;
+        }
+    }
+
+    summary.wall_ms = elapsedMs(wall_start);
+    summary.ocr_area_ratio = decoded_pixels > 0 ? ocr_pixels / decoded_pixels : 0.0;
+    return summary;
+}
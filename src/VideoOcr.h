@@ -0,0 +1,35 @@
+#pragma once
+
+#include "src/api/pipelines/ocr.h"
+#include <string>
+#include <vector>
+
+struct VideoOcrOptions {
+    double frame_diff_threshold = 0.002; // changed thumbnail pixel fraction below which a frame is skipped
+    double full_frame_ratio = 0.4;       // changed area fraction above which the whole frame is re-OCRed
+};
+
+struct VideoOcrSummary {
+    int videos = 0;
+    int frames = 0;
+    int full_frames = 0;    // whole frame through the pipeline
+    int partial_frames = 0; // only changed regions through the pipeline
+    int skipped_frames = 0; // previous result reused as is
+    int failed_frames = 0;
+    long long reused_lines = 0; // lines carried over from the previous result on partial frames
+    double ocr_area_ratio = 0.0; // OCRed pixels / decoded pixels
+    double decode_ms = 0.0;
+    double inference_ms = 0.0;
+    double wall_ms = 0.0;
+};
+
+// Frame by frame OCR of local video files (anything cv::VideoCapture opens).
+// Each frame is compared with the last processed one on a small grayscale
+// thumbnail: unchanged frames reuse the previous result, frames with small
+// changed regions re-OCR only those regions and keep the lines outside them,
+// and everything else goes through the full pipeline. Processed frames are
+// saved as <stem>_frame<NNNNNN>_res.json and reported on PER_FRAME_RESULT lines.
+VideoOcrSummary runVideoOcr(const std::vector<std::string>& videos,
+                            PaddleOCR& infer,
+                            const VideoOcrOptions& options,
+                            const std::string& output_dir);